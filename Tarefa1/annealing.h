@@ -1,6 +1,9 @@
 #ifndef SALEMAN_ANNEALING_H
 #define SALEMAN_ANNEALING_H
 
+#include <algorithm>
+
+#include "events.h"
 #include "map.h"
 
 struct AnnealingParams {
@@ -10,17 +13,30 @@ struct AnnealingParams {
     double actualTemp = initialTemp;
     unsigned int neighborsPerTemp = 10;
     unsigned int stallLimit = 500;
+    double candidateMoveRate = 0.0; // fracao dos movimentos 2-opt guiados pelo grafo de candidatos
 };
 
+// Resfriamento proporcional ao tamanho: os valores padrao de AnnealingParams
+// (alpha = 0) nao resfriam. Usado por solveTimed, particionado e multinivel
+// quando quem chama nao traz parametros (saleman_tune procura melhores).
+inline AnnealingParams defaultAnnealingParams(const size_t n) {
+    AnnealingParams p;
+    p.alpha = 1.0 / (0.2 * static_cast<double>(n));
+    p.stallLimit = 1000;
+    p.candidateMoveRate = 0.5;
+    return p;
+}
+
 struct AnnealingState {
     Path bestPath;
     Path currentPath;
     AnnealingParams params;
-    Problem problem;
+    const Problem *problem = nullptr; // emprestado, sem copia: quem chama o mantem vivo
     double bestDist = std::numeric_limits<double>::infinity();
     unsigned int iterations = 0;
     unsigned int currentIterations = 0;
 	unsigned int stallCounter = 0;
+    uint64_t acceptedMoves = 0; // vizinhos aceitos desde o inicio
 };
 
 inline Path twoOptSwap(Path &path, RNG &rng) {
@@ -35,8 +51,29 @@ inline Path twoOptSwap(Path &path, RNG &rng) {
     return swap;
 }
 
+// 2-opt que torna adjacentes a cidade order[i] e um de seus candidatos.
+inline Path candidateTwoOptSwap(Path &path, const Problem &problem, RNG &rng) {
+    const CandidateGraph &g = problem.candidates;
+    const size_t n = path.order.size();
+    if (n < 3) return path;
+
+    size_t i = rng.randint(0, n - 1);
+    const CityId a = path.order[i];
+    if (g.degree(a) == 0) return twoOptSwap(path, rng);
+    const CityId c = g.neighbors[g.offsets[a] + rng.randint(0, g.degree(a) - 1)];
+    size_t j = static_cast<size_t>(std::find(path.order.begin(), path.order.end(), c) - path.order.begin());
+
+    Path swap = path;
+    if (j > i) {
+        std::reverse(swap.order.begin() + i + 1, swap.order.begin() + j + 1);
+    } else {
+        std::reverse(swap.order.begin() + j, swap.order.begin() + i);
+    }
+    return swap;
+}
+
 inline double routePathLength(const Path& path, const Problem& problem) {
-    return routeLength(path.order, problem.distanceMatrix);
+    return routeLength(path.order, problem);
 }
 
 inline bool runAnnealing(AnnealingState& state, RNG& rng) {
@@ -46,23 +83,28 @@ inline bool runAnnealing(AnnealingState& state, RNG& rng) {
     }
 
     for (unsigned int i = 0; i < state.params.neighborsPerTemp; ++i) {
-        Path candidate = twoOptSwap(state.currentPath, rng);
+        Path candidate = (!state.problem->candidates.empty() &&
+                          rng.rand01() < state.params.candidateMoveRate)
+                             ? candidateTwoOptSwap(state.currentPath, *state.problem, rng)
+                             : twoOptSwap(state.currentPath, rng);
 
-        double current_dist = routePathLength(state.currentPath, state.problem);
-        double candidate_dist = routePathLength(candidate, state.problem);
+        double current_dist = routePathLength(state.currentPath, *state.problem);
+        double candidate_dist = routePathLength(candidate, *state.problem);
 
         if (candidate_dist < current_dist) {
             state.currentPath = candidate;
+            state.acceptedMoves++;
         }
         else {
             const double delta = candidate_dist - current_dist;
             const double acceptance_prob = std::exp(-delta / state.params.actualTemp);
             if (rng.rand01() < acceptance_prob) {
                 state.currentPath = candidate;
+                state.acceptedMoves++;
             }
         }
 
-        double currLen = routePathLength(state.currentPath, state.problem);
+        double currLen = routePathLength(state.currentPath, *state.problem);
         if (currLen < state.bestDist) {
             state.bestDist = currLen;
             state.bestPath = state.currentPath;
@@ -84,4 +126,21 @@ inline bool runAnnealing(AnnealingState& state, RNG& rng) {
         state.stallCounter >= state.params.stallLimit);
 }
 
+// Resfria ate o fim ou ate o observer pedir parada, avisando cada melhora e
+// cada passo de temperatura.
+inline Path anneal(AnnealingState& state, RNG& rng, const SolverObserver* observer = nullptr) {
+    const bool wantsCurrent = observer && observer->onTemperature;
+    bool more = true;
+    while (more) {
+        const double before = state.bestDist;
+        more = runAnnealing(state, rng);
+        state.bestPath.dist = state.bestDist;
+        if (state.bestDist < before && !notifyImprovement(observer, state.bestPath, state.iterations)) break;
+        const double current = wantsCurrent ? routePathLength(state.currentPath, *state.problem) : 0.0;
+        if (!notifyTemperature(observer, state.iterations, state.params.actualTemp, state.bestDist, current)) break;
+    }
+    state.bestPath.dist = state.bestDist;
+    return state.bestPath;
+}
+
 #endif //SALEMAN_ANNEALING_H
\ No newline at end of file
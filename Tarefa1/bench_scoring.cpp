@@ -0,0 +1,184 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "genetic.h"
+#include "kernels.h"
+#include "map.h"
+
+namespace {
+
+const Isa allIsas[] = {Isa::Scalar, Isa::SSE4, Isa::AVX2, Isa::AVX512};
+
+template <typename F>
+double secondsFor(const size_t reps, F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < reps; ++r) f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printRow(const char *kernel, const size_t n, const Isa isa, const double rate, const double scalarRate) {
+    std::printf("%-20s %8zu %10s %14.3e %11.2fx\n", kernel, n, isaName(isa), rate, rate / scalarRate);
+}
+
+// Nome do primeiro kernel de k cujo resultado difere do escalar, ou nullptr.
+// Todos tem de bater bit a bit (kernels.h), inclusive nas sobras de laco:
+// twoOptDeltas e conferido para todo i e compactUntaken para todo tour.
+const char *firstMismatch(const KernelTable &k, const std::vector<const CityId *> &tours, const size_t n,
+                          const double *distM, const int32_t *intM, const std::vector<double> &xs,
+                          const std::vector<double> &ys, const uint8_t *taken)
+{
+    for (const CityId *t : tours)
+    {
+        if (k.routeLength(t, n, distM) != routeLengthScalar(t, n, distM)) return "routeLength";
+        if (k.routeLengthInt(t, n, intM) != routeLengthIntScalar(t, n, intM)) return "routeLengthInt";
+    }
+
+    std::vector<int64_t> lengths(tours.size()), lengthsRef(tours.size());
+    k.routeLengthBatchInt(tours.data(), tours.size(), n, intM, lengths.data());
+    routeLengthBatchIntScalar(tours.data(), tours.size(), n, intM, lengthsRef.data());
+    if (lengths != lengthsRef) return "routeLengthBatchInt";
+
+    std::vector<double> row(n), rowRef(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        k.distanceRow(xs.data(), ys.data(), i, n, row.data());
+        distanceRowScalar(xs.data(), ys.data(), i, n, rowRef.data());
+        if (row != rowRef) return "distanceRow";
+    }
+
+    std::vector<double> deltas(n), deltasRef(n);
+    std::vector<int64_t> intDeltas(n), intDeltasRef(n);
+    const CityId *order = tours[0];
+    for (size_t i = 0; i + 2 < n; ++i)
+    {
+        k.twoOptDeltas(order, n, distM, i, i + 2, n, deltas.data());
+        twoOptDeltasScalar(order, n, distM, i, i + 2, n, deltasRef.data());
+        if (deltas != deltasRef) return "twoOptDeltas";
+        k.twoOptDeltasInt(order, n, intM, i, i + 2, n, intDeltas.data());
+        twoOptDeltasIntScalar(order, n, intM, i, i + 2, n, intDeltasRef.data());
+        if (intDeltas != intDeltasRef) return "twoOptDeltasInt";
+    }
+
+    std::vector<CityId> compacted(n + 16), compactedRef(n + 16);
+    for (const CityId *t : tours)
+    {
+        const size_t count = k.compactUntaken(t, n, taken, compacted.data());
+        if (count != compactUntakenScalar(t, n, taken, compactedRef.data()) ||
+            !std::equal(compacted.begin(), compacted.begin() + count, compactedRef.begin()))
+            return "compactUntaken";
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// Vazao de cada kernel despachado (elementos por segundo) para cada conjunto
+// de instrucoes disponivel nesta maquina: arestas de tour para routeLength,
+// routeLengthBatch e routeLengthBatchInt, distancias para distanceRow,
+// movimentos 2-opt avaliados para twoOptDeltas e genes examinados para
+// compactUntaken. Antes das medidas, cada kernel de cada nivel e comparado
+// com a versao escalar.
+int main()
+{
+    constexpr size_t populationSize = 1024;
+    RNG rng(42);
+
+    std::printf("dispatch: %s\n", isaName(kernels().isa));
+    std::printf("%-20s %8s %10s %14s %12s\n", "kernel", "cities", "isa", "elements/s", "speedup");
+
+    for (const size_t n : {125, 1000, 5000})
+    {
+        Problem problem;
+        initializeMap(problem.map, 10000, 10000);
+        populateCities(problem, rng, problem.map, static_cast<unsigned int>(n));
+        problem.distanceMatrix = buildDistanceMatrix(problem);
+        const double *distM = problem.distanceMatrix.data();
+        problem.metric = Metric::Euc2D; // matriz int32 das metricas TSPLIB
+        const std::vector<int32_t> intMatrix = buildIntDistanceMatrix(problem);
+
+        std::vector<Path> pop(populationSize);
+        initPopulation(pop, n, rng);
+        std::vector<const CityId*> tours(pop.size());
+        for (size_t i = 0; i < pop.size(); ++i) tours[i] = pop[i].order.data();
+
+        std::vector<double> xs(n), ys(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            xs[i] = problem.cities[i].x;
+            ys[i] = problem.cities[i].y;
+        }
+        std::vector<uint8_t> taken(n + 3, 0);
+        for (size_t i = 0; i < n; i += 2) taken[i] = 1;
+
+        const size_t reps = std::max<size_t>(1, 50000000 / (n * populationSize));
+        std::vector<double> reference(pop.size());
+        std::vector<double> out(pop.size());
+        std::vector<int64_t> intOut(pop.size());
+        routeLengthBatchScalar(tours.data(), tours.size(), n, distM, reference.data());
+
+        std::vector<double> row(n), deltas(n);
+        std::vector<CityId> compacted(n + 16);
+        double scalarRate[6] = {};
+        for (const Isa isa : allIsas)
+        {
+            if (!isaSupported(isa)) continue;
+            const KernelTable k = kernelTable(isa);
+            const bool first = isa == Isa::Scalar;
+            double volatile sink = 0.0;
+
+            if (const char *bad = firstMismatch(k, tours, n, distM, intMatrix.data(), xs, ys, taken.data()))
+            {
+                std::printf("%-20s %8zu %10s mismatch against scalar\n", bad, n, isaName(isa));
+                return 1;
+            }
+
+            double secs = secondsFor(reps, [&] { k.routeLengthBatch(tours.data(), tours.size(), n, distM, out.data()); });
+            if (out != reference)
+            {
+                std::printf("%8zu %10s mismatch against scalar\n", n, isaName(isa));
+                return 1;
+            }
+            double rate = static_cast<double>(reps * populationSize * n) / secs;
+            if (first) scalarRate[0] = rate;
+            printRow("routeLengthBatch", n, isa, rate, scalarRate[0]);
+
+            secs = secondsFor(reps, [&] {
+                k.routeLengthBatchInt(tours.data(), tours.size(), n, intMatrix.data(), intOut.data());
+            });
+            rate = static_cast<double>(reps * populationSize * n) / secs;
+            if (first) scalarRate[5] = rate;
+            printRow("routeLengthBatchInt", n, isa, rate, scalarRate[5]);
+
+            secs = secondsFor(reps, [&] {
+                for (const CityId *t : tours) sink = sink + k.routeLength(t, n, distM);
+            });
+            rate = static_cast<double>(reps * populationSize * n) / secs;
+            if (first) scalarRate[1] = rate;
+            printRow("routeLength", n, isa, rate, scalarRate[1]);
+
+            const size_t rowReps = std::max<size_t>(1, 20000000 / (n * n));
+            secs = secondsFor(rowReps, [&] {
+                for (size_t i = 0; i < n; ++i) k.distanceRow(xs.data(), ys.data(), i, n, row.data());
+            });
+            rate = static_cast<double>(rowReps * n * n) / secs;
+            if (first) scalarRate[2] = rate;
+            printRow("distanceRow", n, isa, rate, scalarRate[2]);
+
+            secs = secondsFor(rowReps, [&] {
+                for (size_t i = 0; i + 2 < n; ++i) k.twoOptDeltas(tours[0], n, distM, i, i + 2, n, deltas.data());
+            });
+            rate = static_cast<double>(rowReps * (n - 2) * (n - 1) / 2) / secs;
+            if (first) scalarRate[3] = rate;
+            printRow("twoOptDeltas", n, isa, rate, scalarRate[3]);
+
+            secs = secondsFor(reps, [&] {
+                for (const CityId *t : tours) sink = sink + static_cast<double>(k.compactUntaken(t, n, taken.data(), compacted.data()));
+            });
+            rate = static_cast<double>(reps * populationSize * n) / secs;
+            if (first) scalarRate[4] = rate;
+            printRow("compactUntaken", n, isa, rate, scalarRate[4]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,269 @@
+#ifndef SALEMAN_CANDIDATES_H
+#define SALEMAN_CANDIDATES_H
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "map.h"
+
+// Grade uniforme de baldes sobre as cidades, usada para buscas de vizinhanca
+// sem varrer todas as n cidades.
+struct SpatialGrid {
+    unsigned int minX{0}, minY{0};
+    double cellSize{1.0};
+    size_t cols{1}, rows{1};
+    std::vector<uint32_t> cellStart;
+    std::vector<CityId> items;
+
+    [[nodiscard]] size_t cellX(const unsigned int x) const noexcept {
+        return std::min(cols - 1, static_cast<size_t>((x - minX) / cellSize));
+    }
+    [[nodiscard]] size_t cellY(const unsigned int y) const noexcept {
+        return std::min(rows - 1, static_cast<size_t>((y - minY) / cellSize));
+    }
+};
+
+inline SpatialGrid buildSpatialGrid(const Problem &problem, const double citiesPerCell = 2.0) {
+    SpatialGrid grid;
+    const size_t n = problem.numCities();
+    if (n == 0) {
+        grid.cellStart.assign(2, 0);
+        return grid;
+    }
+
+    unsigned int maxX = problem.cities[0].x, maxY = problem.cities[0].y;
+    grid.minX = maxX;
+    grid.minY = maxY;
+    for (const auto &c : problem.cities) {
+        grid.minX = std::min(grid.minX, c.x);
+        grid.minY = std::min(grid.minY, c.y);
+        maxX = std::max(maxX, c.x);
+        maxY = std::max(maxY, c.y);
+    }
+    const double w = static_cast<double>(maxX - grid.minX) + 1.0;
+    const double h = static_cast<double>(maxY - grid.minY) + 1.0;
+    grid.cellSize = std::max(1.0, std::sqrt(w * h * citiesPerCell / static_cast<double>(n)));
+    grid.cols = static_cast<size_t>(std::ceil(w / grid.cellSize));
+    grid.rows = static_cast<size_t>(std::ceil(h / grid.cellSize));
+
+    std::vector<uint32_t> cellOf(n);
+    grid.cellStart.assign(grid.cols * grid.rows + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        const auto &c = problem.cities[i];
+        cellOf[i] = static_cast<uint32_t>(grid.cellY(c.y) * grid.cols + grid.cellX(c.x));
+        ++grid.cellStart[cellOf[i] + 1];
+    }
+    for (size_t c = 0; c + 1 < grid.cellStart.size(); ++c) grid.cellStart[c + 1] += grid.cellStart[c];
+
+    grid.items.resize(n);
+    std::vector<uint32_t> fill(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) grid.items[fill[cellOf[i]]++] = static_cast<CityId>(i);
+    return grid;
+}
+
+// As k cidades mais proximas de `city` (excluindo ela mesma), ordenadas por distancia.
+inline void nearestNeighbors(const SpatialGrid &grid, const Problem &problem, const size_t city,
+                             const size_t k, std::vector<std::pair<double, CityId>> &out) {
+    out.clear();
+    if (k == 0) return;
+    const City &c = problem.cities[city];
+    const auto cx = static_cast<long long>(grid.cellX(c.x));
+    const auto cy = static_cast<long long>(grid.cellY(c.y));
+    const long long maxRing = static_cast<long long>(std::max(grid.cols, grid.rows));
+
+    std::priority_queue<std::pair<double, CityId>> heap;
+    auto visitCell = [&](const long long gx, const long long gy) {
+        if (gx < 0 || gy < 0 || gx >= static_cast<long long>(grid.cols) ||
+            gy >= static_cast<long long>(grid.rows))
+            return;
+        const size_t cell = static_cast<size_t>(gy) * grid.cols + static_cast<size_t>(gx);
+        for (uint32_t p = grid.cellStart[cell]; p < grid.cellStart[cell + 1]; ++p) {
+            const CityId other = grid.items[p];
+            if (other == city) continue;
+            const double d = euclid(c.x, c.y, problem.cities[other].x, problem.cities[other].y);
+            if (heap.size() < k) {
+                heap.emplace(d, other);
+            } else if (d < heap.top().first) {
+                heap.pop();
+                heap.emplace(d, other);
+            }
+        }
+    };
+
+    for (long long r = 0; r <= maxRing; ++r) {
+        if (r == 0) {
+            visitCell(cx, cy);
+        } else {
+            for (long long gx = cx - r; gx <= cx + r; ++gx) {
+                visitCell(gx, cy - r);
+                visitCell(gx, cy + r);
+            }
+            for (long long gy = cy - r + 1; gy <= cy + r - 1; ++gy) {
+                visitCell(cx - r, gy);
+                visitCell(cx + r, gy);
+            }
+        }
+        // qualquer cidade fora dos aneis ja visitados esta a pelo menos r * cellSize
+        if (heap.size() == k && heap.top().first <= static_cast<double>(r) * grid.cellSize) break;
+    }
+
+    out.resize(heap.size());
+    for (size_t i = heap.size(); i-- > 0;) {
+        out[i] = heap.top();
+        heap.pop();
+    }
+}
+
+// Grafo de candidatos com os k vizinhos mais proximos de cada cidade.
+inline CandidateGraph buildNearestNeighborCandidates(const Problem &problem, const size_t k) {
+    const size_t n = problem.numCities();
+    const SpatialGrid grid = buildSpatialGrid(problem);
+
+    CandidateGraph g;
+    g.offsets.reserve(n + 1);
+    g.neighbors.reserve(n * k);
+    g.dists.reserve(n * k);
+    g.offsets.push_back(0);
+
+    std::vector<std::pair<double, CityId>> found;
+    for (size_t i = 0; i < n; ++i) {
+        nearestNeighbors(grid, problem, i, k, found);
+        for (const auto &[d, j] : found) {
+            g.neighbors.push_back(j);
+            g.dists.push_back(static_cast<float>(applyMetric(problem.metric, d)));
+        }
+        g.offsets.push_back(static_cast<uint32_t>(g.neighbors.size()));
+    }
+    return g;
+}
+
+// Troca a matriz densa n^2 pelo grafo de candidatos esparso; pares fora do
+// grafo passam a ser calculados sob demanda por Problem::distance.
+inline void useSparseDistances(Problem &problem, CandidateGraph candidates) {
+    problem.candidates = std::move(candidates);
+    problem.distanceMatrix = {};
+    problem.intDistanceMatrix = {};
+    problem.externalMatrix = nullptr;
+}
+
+inline void useSparseDistances(Problem &problem, const size_t k) {
+    useSparseDistances(problem, buildNearestNeighborCandidates(problem, k));
+}
+
+struct DisjointSets {
+    std::vector<CityId> parent;
+    explicit DisjointSets(const size_t n) : parent(n) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+    CityId find(CityId x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+    bool unite(const CityId a, const CityId b) {
+        const CityId ra = find(a), rb = find(b);
+        if (ra == rb) return false;
+        parent[ra] = rb;
+        return true;
+    }
+};
+
+// Arestas (i < j) do grafo de candidatos ordenadas por distancia.
+inline std::vector<std::pair<CityId, CityId>> sortedCandidateEdges(const Problem &problem) {
+    const CandidateGraph &g = problem.candidates;
+    std::vector<std::pair<float, std::pair<CityId, CityId>>> edges;
+    for (size_t i = 0; i + 1 < g.offsets.size(); ++i) {
+        for (uint32_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+            if (i < g.neighbors[k]) edges.push_back({g.dists[k], {static_cast<CityId>(i), g.neighbors[k]}});
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    std::vector<std::pair<CityId, CityId>> result(edges.size());
+    for (size_t e = 0; e < edges.size(); ++e) result[e] = edges[e].second;
+    return result;
+}
+
+// Heuristica construtiva greedy-edge restrita ao grafo de candidatos: aceita
+// as arestas mais curtas que nao criem grau 3 nem ciclo e depois liga os
+// fragmentos restantes pelo extremo livre mais proximo.
+inline Path greedyEdgeTour(const Problem &problem) {
+    const size_t n = problem.numCities();
+    constexpr CityId none = std::numeric_limits<CityId>::max();
+    std::vector<CityId> adj(2 * n, none);
+    std::vector<uint8_t> degree(n, 0);
+    DisjointSets sets(n);
+
+    for (const auto &[a, b] : sortedCandidateEdges(problem)) {
+        if (degree[a] >= 2 || degree[b] >= 2 || !sets.unite(a, b)) continue;
+        adj[2 * a + degree[a]++] = b;
+        adj[2 * b + degree[b]++] = a;
+    }
+
+    std::vector<CityId> endpoints;
+    for (size_t i = 0; i < n; ++i) {
+        if (degree[i] < 2) endpoints.push_back(static_cast<CityId>(i));
+    }
+
+    Path path;
+    path.order.reserve(n);
+    std::vector<char> visited(n, false);
+    CityId cur = endpoints.empty() ? 0 : endpoints.front();
+    while (path.order.size() < n) {
+        // percorre o fragmento a partir de um extremo
+        while (true) {
+            path.order.push_back(cur);
+            visited[cur] = true;
+            CityId next = none;
+            for (int s = 0; s < degree[cur]; ++s) {
+                if (!visited[adj[2 * cur + s]]) next = adj[2 * cur + s];
+            }
+            if (next == none) break;
+            cur = next;
+        }
+        if (path.order.size() == n) break;
+
+        double best = std::numeric_limits<double>::infinity();
+        size_t bestIdx = 0;
+        size_t live = 0;
+        for (size_t e = 0; e < endpoints.size(); ++e) {
+            if (visited[endpoints[e]]) continue;
+            endpoints[live] = endpoints[e];
+            const double d = problem.distance(cur, endpoints[live]);
+            if (d < best) {
+                best = d;
+                bestIdx = live;
+            }
+            ++live;
+        }
+        endpoints.resize(live);
+        cur = endpoints[bestIdx];
+    }
+    path.dist = routeLength(path.order, problem);
+    return path;
+}
+
+// Peso da arvore geradora minima sobre o grafo de candidatos. Todo tour menos
+// uma aresta e uma arvore geradora, logo o valor e um limite inferior valido
+// sempre que o grafo contem a MST euclidiana (caso da triangulacao de Delaunay).
+// Nas metricas inteiras o arredondamento e monotono, entao a mesma arvore
+// continua minima.
+inline double spanningTreeLowerBound(const Problem &problem) {
+    const size_t n = problem.numCities();
+    DisjointSets sets(n);
+    double total = 0.0;
+    size_t used = 0;
+    for (const auto &[a, b] : sortedCandidateEdges(problem)) {
+        if (!sets.unite(a, b)) continue;
+        total += problem.cityDistance(a, b);
+        if (++used + 1 == n) break;
+    }
+    return total;
+}
+
+#endif //SALEMAN_CANDIDATES_H
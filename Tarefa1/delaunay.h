@@ -0,0 +1,461 @@
+#ifndef SALEMAN_DELAUNAY_H
+#define SALEMAN_DELAUNAY_H
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "candidates.h"
+#include "map.h"
+
+// Triangulacao de Delaunay por sweep-hull (estilo Delaunator): os pontos sao
+// inseridos em ordem de distancia ao centro do triangulo semente, o fecho
+// convexo e mantido como lista duplamente ligada com hash por angulo e as
+// arestas sao legalizadas por flips. O(n log n) no caso tipico.
+class DelaunayTriangulation {
+public:
+    std::vector<CityId> triangles; // 3 vertices por triangulo
+    std::vector<int64_t> halfedges; // semi-aresta oposta ou -1 no fecho
+
+    explicit DelaunayTriangulation(const Problem &problem) : coords(problem.numCities() * 2) {
+        for (size_t i = 0; i < problem.numCities(); ++i) {
+            coords[2 * i] = static_cast<double>(problem.cities[i].x);
+            coords[2 * i + 1] = static_cast<double>(problem.cities[i].y);
+        }
+        triangulate();
+    }
+
+    // Arestas nao direcionadas (a, b) da triangulacao, cada uma uma vez.
+    [[nodiscard]] std::vector<std::pair<CityId, CityId>> edges() const {
+        std::vector<std::pair<CityId, CityId>> result;
+        result.reserve(triangles.size() / 2 + 1);
+        for (size_t e = 0; e < triangles.size(); ++e) {
+            if (halfedges[e] == -1 || static_cast<int64_t>(e) > halfedges[e]) {
+                result.emplace_back(triangles[e], triangles[nextHalfedge(e)]);
+            }
+        }
+        return result;
+    }
+
+private:
+    std::vector<double> coords;
+    std::vector<size_t> hullPrev, hullNext, hullTri;
+    std::vector<int64_t> hullHash;
+    std::vector<size_t> edgeStack;
+    size_t hullStart = 0;
+    double cx = 0.0, cy = 0.0;
+
+    static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+    static size_t nextHalfedge(const size_t e) noexcept { return (e % 3 == 2) ? e - 2 : e + 1; }
+
+    [[nodiscard]] double px(const size_t i) const noexcept { return coords[2 * i]; }
+    [[nodiscard]] double py(const size_t i) const noexcept { return coords[2 * i + 1]; }
+
+    // verdadeiro quando p, q, r estao em sentido anti-horario
+    [[nodiscard]] bool orient(const double x, const double y, const size_t q,
+                              const size_t r) const noexcept {
+        return (py(q) - y) * (px(r) - px(q)) - (px(q) - x) * (py(r) - py(q)) < 0.0;
+    }
+
+    static double circumradius2(const double ax, const double ay, const double bx, const double by,
+                                const double qx, const double qy) noexcept {
+        const double dx = bx - ax, dy = by - ay;
+        const double ex = qx - ax, ey = qy - ay;
+        const double bl = dx * dx + dy * dy;
+        const double cl = ex * ex + ey * ey;
+        const double d = 0.5 / (dx * ey - dy * ex);
+        const double x = (ey * bl - dy * cl) * d;
+        const double y = (dx * cl - ex * bl) * d;
+        return x * x + y * y;
+    }
+
+    static std::pair<double, double> circumcenter(const double ax, const double ay, const double bx,
+                                                  const double by, const double qx,
+                                                  const double qy) noexcept {
+        const double dx = bx - ax, dy = by - ay;
+        const double ex = qx - ax, ey = qy - ay;
+        const double bl = dx * dx + dy * dy;
+        const double cl = ex * ex + ey * ey;
+        const double d = 0.5 / (dx * ey - dy * ex);
+        return {ax + (ey * bl - dy * cl) * d, ay + (dx * cl - ex * bl) * d};
+    }
+
+    [[nodiscard]] bool inCircle(const size_t a, const size_t b, const size_t c,
+                                const size_t p) const noexcept {
+        const double dx = px(a) - px(p), dy = py(a) - py(p);
+        const double ex = px(b) - px(p), ey = py(b) - py(p);
+        const double fx = px(c) - px(p), fy = py(c) - py(p);
+        const double ap = dx * dx + dy * dy;
+        const double bp = ex * ex + ey * ey;
+        const double cp = fx * fx + fy * fy;
+        return dx * (ey * cp - bp * fy) - dy * (ex * cp - bp * fx) + ap * (ex * fy - ey * fx) < 0.0;
+    }
+
+    [[nodiscard]] size_t hashKey(const double x, const double y) const noexcept {
+        const double dx = x - cx, dy = y - cy;
+        const double p = dx / (std::abs(dx) + std::abs(dy));
+        const double angle = (dy > 0.0 ? 3.0 - p : 1.0 + p) / 4.0; // pseudo-angulo em [0, 1]
+        const auto size = static_cast<double>(hullHash.size());
+        return static_cast<size_t>(std::floor(angle * size)) % hullHash.size();
+    }
+
+    void link(const size_t a, const int64_t b) {
+        halfedges[a] = b;
+        if (b != -1) halfedges[static_cast<size_t>(b)] = static_cast<int64_t>(a);
+    }
+
+    size_t addTriangle(const size_t i0, const size_t i1, const size_t i2, const int64_t a,
+                       const int64_t b, const int64_t c) {
+        const size_t t = triangles.size();
+        triangles.push_back(static_cast<CityId>(i0));
+        triangles.push_back(static_cast<CityId>(i1));
+        triangles.push_back(static_cast<CityId>(i2));
+        halfedges.resize(t + 3, -1);
+        link(t, a);
+        link(t + 1, b);
+        link(t + 2, c);
+        return t;
+    }
+
+    size_t legalize(size_t a) {
+        size_t ar = 0;
+        edgeStack.clear();
+        while (true) {
+            const int64_t hb = halfedges[a];
+            const size_t a0 = a - a % 3;
+            ar = a0 + (a + 2) % 3;
+
+            if (hb == -1) {
+                if (edgeStack.empty()) break;
+                a = edgeStack.back();
+                edgeStack.pop_back();
+                continue;
+            }
+
+            const auto b = static_cast<size_t>(hb);
+            const size_t b0 = b - b % 3;
+            const size_t al = a0 + (a + 1) % 3;
+            const size_t bl = b0 + (b + 2) % 3;
+
+            const size_t p0 = triangles[ar];
+            const size_t pr = triangles[a];
+            const size_t pl = triangles[al];
+            const size_t p1 = triangles[bl];
+
+            if (inCircle(p0, pr, pl, p1)) {
+                triangles[a] = static_cast<CityId>(p1);
+                triangles[b] = static_cast<CityId>(p0);
+
+                const int64_t hbl = halfedges[bl];
+                if (hbl == -1) {
+                    // aresta trocada do outro lado do fecho: corrige a referencia
+                    size_t e = hullStart;
+                    do {
+                        if (hullTri[e] == bl) {
+                            hullTri[e] = a;
+                            break;
+                        }
+                        e = hullPrev[e];
+                    } while (e != hullStart);
+                }
+                link(a, hbl);
+                link(b, halfedges[ar]);
+                link(ar, static_cast<int64_t>(bl));
+                edgeStack.push_back(b0 + (b + 1) % 3);
+            } else {
+                if (edgeStack.empty()) break;
+                a = edgeStack.back();
+                edgeStack.pop_back();
+            }
+        }
+        return ar;
+    }
+
+    void triangulate() {
+        const size_t n = coords.size() / 2;
+        if (n < 3) return;
+
+        double minX = std::numeric_limits<double>::infinity(), minY = minX;
+        double maxX = -minX, maxY = -minX;
+        for (size_t i = 0; i < n; ++i) {
+            minX = std::min(minX, px(i));
+            minY = std::min(minY, py(i));
+            maxX = std::max(maxX, px(i));
+            maxY = std::max(maxY, py(i));
+        }
+        const double midX = (minX + maxX) / 2.0, midY = (minY + maxY) / 2.0;
+
+        auto dist2 = [](const double ax, const double ay, const double bx, const double by) {
+            return (ax - bx) * (ax - bx) + (ay - by) * (ay - by);
+        };
+
+        // triangulo semente: ponto mais central, seu vizinho mais proximo e o
+        // terceiro ponto que forma o menor circulo circunscrito
+        size_t i0 = 0, i1 = none, i2 = none;
+        double minDist = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+            const double d = dist2(midX, midY, px(i), py(i));
+            if (d < minDist) {
+                i0 = i;
+                minDist = d;
+            }
+        }
+        minDist = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+            if (i == i0) continue;
+            const double d = dist2(px(i0), py(i0), px(i), py(i));
+            if (d < minDist && d > 0.0) {
+                i1 = i;
+                minDist = d;
+            }
+        }
+        if (i1 == none) return;
+        double minRadius = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+            if (i == i0 || i == i1) continue;
+            const double r = circumradius2(px(i0), py(i0), px(i1), py(i1), px(i), py(i));
+            if (r < minRadius) {
+                i2 = i;
+                minRadius = r;
+            }
+        }
+        if (i2 == none || !std::isfinite(minRadius)) return; // todos colineares
+
+        if (orient(px(i0), py(i0), i1, i2)) std::swap(i1, i2);
+        const auto [centerX, centerY] = circumcenter(px(i0), py(i0), px(i1), py(i1), px(i2), py(i2));
+        cx = centerX;
+        cy = centerY;
+
+        std::vector<double> dists(n);
+        for (size_t i = 0; i < n; ++i) dists[i] = dist2(px(i), py(i), cx, cy);
+        std::vector<size_t> ids(n);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::sort(ids.begin(), ids.end(),
+                  [&dists](const size_t a, const size_t b) { return dists[a] < dists[b]; });
+
+        const auto hashSize = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+        hullPrev.assign(n, 0);
+        hullNext.assign(n, 0);
+        hullTri.assign(n, 0);
+        hullHash.assign(hashSize, -1);
+        triangles.reserve(6 * n);
+        halfedges.reserve(6 * n);
+
+        hullStart = i0;
+        hullNext[i0] = hullPrev[i2] = i1;
+        hullNext[i1] = hullPrev[i0] = i2;
+        hullNext[i2] = hullPrev[i1] = i0;
+        hullTri[i0] = 0;
+        hullTri[i1] = 1;
+        hullTri[i2] = 2;
+        hullHash[hashKey(px(i0), py(i0))] = static_cast<int64_t>(i0);
+        hullHash[hashKey(px(i1), py(i1))] = static_cast<int64_t>(i1);
+        hullHash[hashKey(px(i2), py(i2))] = static_cast<int64_t>(i2);
+        addTriangle(i0, i1, i2, -1, -1, -1);
+
+        double xp = 0.0, yp = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            const size_t i = ids[k];
+            const double x = px(i), y = py(i);
+
+            // pontos duplicados ficam fora da triangulacao
+            if (k > 0 && x == xp && y == yp) continue;
+            xp = x;
+            yp = y;
+            if (i == i0 || i == i1 || i == i2) continue;
+
+            size_t start = 0;
+            const size_t key = hashKey(x, y);
+            for (size_t j = 0; j < hashSize; ++j) {
+                const int64_t h = hullHash[(key + j) % hashSize];
+                if (h != -1 && static_cast<size_t>(h) != hullNext[static_cast<size_t>(h)]) {
+                    start = static_cast<size_t>(h);
+                    break;
+                }
+            }
+            start = hullPrev[start];
+
+            // aresta do fecho visivel a partir do novo ponto
+            size_t e = start;
+            bool visible = true;
+            while (!orient(x, y, e, hullNext[e])) {
+                e = hullNext[e];
+                if (e == start) {
+                    visible = false;
+                    break;
+                }
+            }
+            if (!visible) continue;
+
+            size_t t = addTriangle(e, i, hullNext[e], -1, -1, static_cast<int64_t>(hullTri[e]));
+            hullTri[i] = legalize(t + 2);
+            hullTri[e] = t;
+
+            size_t nx = hullNext[e];
+            for (size_t q = hullNext[nx]; orient(x, y, nx, q); q = hullNext[nx]) {
+                t = addTriangle(nx, i, q, static_cast<int64_t>(hullTri[i]), -1,
+                                static_cast<int64_t>(hullTri[nx]));
+                hullTri[i] = legalize(t + 2);
+                hullNext[nx] = nx; // removido do fecho
+                nx = q;
+            }
+
+            if (e == start) {
+                for (size_t q = hullPrev[e]; orient(x, y, q, e); q = hullPrev[e]) {
+                    t = addTriangle(q, i, e, -1, static_cast<int64_t>(hullTri[e]),
+                                    static_cast<int64_t>(hullTri[q]));
+                    legalize(t + 2);
+                    hullTri[q] = t;
+                    hullNext[e] = e;
+                    e = q;
+                }
+            }
+
+            hullStart = hullPrev[i] = e;
+            hullNext[e] = hullPrev[nx] = i;
+            hullNext[i] = nx;
+            hullHash[hashKey(x, y)] = static_cast<int64_t>(i);
+            hullHash[hashKey(px(e), py(e))] = static_cast<int64_t>(e);
+        }
+    }
+};
+
+// Raio maximo da busca, em aneis de celulas da grade (~2 cidades por
+// celula). Um quadrante vazio, como o lado de fora de uma cidade na borda,
+// faria a busca varrer a grade ate a parede oposta: O(n) por cidade e
+// O(n^1.5) no total. Com o raio limitado cada cidade visita O(1) celulas; o
+// que fica mais longe ja esta ligado pela triangulacao.
+inline constexpr long long quadrantMaxRing = 8;
+
+// Vizinho mais proximo em cada um dos quatro quadrantes ao redor de cada
+// cidade; completa a triangulacao em instancias agrupadas.
+inline std::vector<std::pair<CityId, CityId>> quadrantNeighborEdges(const Problem &problem,
+                                                                    const size_t perQuadrant) {
+    std::vector<std::pair<CityId, CityId>> result;
+    const size_t n = problem.numCities();
+    if (perQuadrant == 0 || n < 2) return result;
+    const SpatialGrid grid = buildSpatialGrid(problem);
+
+    std::vector<std::pair<double, CityId>> heaps[4];
+    auto heapLess = [](const auto &a, const auto &b) { return a.first < b.first; };
+
+    for (size_t i = 0; i < n; ++i) {
+        const City &c = problem.cities[i];
+        const auto cx = static_cast<long long>(grid.cellX(c.x));
+        const auto cy = static_cast<long long>(grid.cellY(c.y));
+        const long long maxRing = std::min(quadrantMaxRing,
+            std::max(std::max(cx, static_cast<long long>(grid.cols) - 1 - cx),
+                     std::max(cy, static_cast<long long>(grid.rows) - 1 - cy)));
+        for (auto &h : heaps) h.clear();
+
+        auto visitCell = [&](const long long gx, const long long gy) {
+            if (gx < 0 || gy < 0 || gx >= static_cast<long long>(grid.cols) ||
+                gy >= static_cast<long long>(grid.rows))
+                return;
+            const size_t cell = static_cast<size_t>(gy) * grid.cols + static_cast<size_t>(gx);
+            for (uint32_t p = grid.cellStart[cell]; p < grid.cellStart[cell + 1]; ++p) {
+                const CityId other = grid.items[p];
+                if (other == i) continue;
+                const City &o = problem.cities[other];
+                const long long dx = static_cast<long long>(o.x) - c.x;
+                const long long dy = static_cast<long long>(o.y) - c.y;
+                const int q = (dx >= 0 && dy > 0) ? 0 : (dx < 0 && dy >= 0) ? 1 : (dx <= 0 && dy < 0) ? 2 : 3;
+                auto &h = heaps[q];
+                const double d = euclid(c.x, c.y, o.x, o.y);
+                if (h.size() < perQuadrant) {
+                    h.emplace_back(d, other);
+                    std::push_heap(h.begin(), h.end(), heapLess);
+                } else if (d < h.front().first) {
+                    std::pop_heap(h.begin(), h.end(), heapLess);
+                    h.back() = {d, other};
+                    std::push_heap(h.begin(), h.end(), heapLess);
+                }
+            }
+        };
+
+        for (long long r = 0; r <= maxRing; ++r) {
+            if (r == 0) {
+                visitCell(cx, cy);
+            } else {
+                for (long long gx = cx - r; gx <= cx + r; ++gx) {
+                    visitCell(gx, cy - r);
+                    visitCell(gx, cy + r);
+                }
+                for (long long gy = cy - r + 1; gy <= cy + r - 1; ++gy) {
+                    visitCell(cx - r, gy);
+                    visitCell(cx + r, gy);
+                }
+            }
+            const double reach = static_cast<double>(r) * grid.cellSize;
+            bool done = true;
+            for (const auto &h : heaps) {
+                if (h.size() < perQuadrant || h.front().first > reach) done = false;
+            }
+            if (done) break;
+        }
+
+        for (const auto &h : heaps) {
+            for (const auto &entry : h) result.emplace_back(static_cast<CityId>(i), entry.second);
+        }
+    }
+    return result;
+}
+
+// Monta o grafo de candidatos CSR (simetrico, cada linha ordenada por
+// distancia) a partir de uma lista de arestas.
+inline CandidateGraph candidateGraphFromEdges(const Problem &problem,
+                                              const std::vector<std::pair<CityId, CityId>> &edges) {
+    const size_t n = problem.numCities();
+    std::vector<std::vector<std::pair<float, CityId>>> rows(n);
+    for (const auto &[a, b] : edges) {
+        if (a == b) continue;
+        const auto d = static_cast<float>(problem.cityDistance(a, b));
+        rows[a].emplace_back(d, b);
+        rows[b].emplace_back(d, a);
+    }
+
+    CandidateGraph g;
+    g.offsets.reserve(n + 1);
+    g.offsets.push_back(0);
+    for (auto &row : rows) {
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        for (const auto &[d, j] : row) {
+            g.neighbors.push_back(j);
+            g.dists.push_back(d);
+        }
+        g.offsets.push_back(static_cast<uint32_t>(g.neighbors.size()));
+        std::vector<std::pair<float, CityId>>().swap(row);
+    }
+    return g;
+}
+
+// Candidatos = arestas de Delaunay, opcionalmente unidas aos vizinhos por
+// quadrante. Cidades fora da triangulacao (duplicadas ou instancia colinear)
+// recebem seus vizinhos mais proximos.
+inline CandidateGraph buildDelaunayCandidates(const Problem &problem, const size_t quadrantK = 0) {
+    std::vector<std::pair<CityId, CityId>> edges = DelaunayTriangulation(problem).edges();
+    if (quadrantK > 0) {
+        const auto quad = quadrantNeighborEdges(problem, quadrantK);
+        edges.insert(edges.end(), quad.begin(), quad.end());
+    }
+
+    const size_t n = problem.numCities();
+    std::vector<char> covered(n, false);
+    for (const auto &[a, b] : edges) covered[a] = covered[b] = true;
+    if (std::find(covered.begin(), covered.end(), false) != covered.end()) {
+        const SpatialGrid grid = buildSpatialGrid(problem);
+        std::vector<std::pair<double, CityId>> found;
+        for (size_t i = 0; i < n; ++i) {
+            if (covered[i]) continue;
+            nearestNeighbors(grid, problem, i, 5, found);
+            for (const auto &entry : found) edges.emplace_back(static_cast<CityId>(i), entry.second);
+        }
+    }
+    return candidateGraphFromEdges(problem, edges);
+}
+
+#endif //SALEMAN_DELAUNAY_H
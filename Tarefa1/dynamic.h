@@ -0,0 +1,214 @@
+#ifndef SALEMAN_DYNAMIC_H
+#define SALEMAN_DYNAMIC_H
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "annealing.h"
+#include "genetic.h"
+#include "map.h"
+
+// Atualizacoes de instancia durante a execucao: cidades entram e saem sem
+// reconstruir o Problem nem reiniciar os algoritmos. Uma nova cidade recebe o
+// indice n; ao remover a cidade r, a ultima cidade passa a ocupar o indice r.
+// Uma matriz emprestada (externalMatrix) nao pode ser redimensionada aqui.
+
+// Insere a nova cidade no grafo de candidatos: recebe seus vizinhos mais
+// proximos e entra na lista das cidades que a tem mais perto que seu pior candidato.
+inline void addCandidates(Problem &problem, const CityId id) {
+    CandidateGraph &g = problem.candidates;
+    const size_t n = problem.numCities();
+    const size_t k = std::max<size_t>(1, g.neighbors.size() / std::max<size_t>(1, n - 1));
+
+    std::vector<std::pair<float, CityId>> nearest;
+    nearest.reserve(n);
+    for (size_t j = 0; j < id; ++j) {
+        nearest.emplace_back(static_cast<float>(problem.cityDistance(id, j)), static_cast<CityId>(j));
+    }
+    const size_t keep = std::min(k, nearest.size());
+    std::partial_sort(nearest.begin(), nearest.begin() + keep, nearest.end());
+
+    CandidateGraph updated;
+    updated.offsets.reserve(n + 1);
+    updated.neighbors.reserve(g.neighbors.size() + 2 * keep);
+    updated.dists.reserve(g.dists.size() + 2 * keep);
+    updated.offsets.push_back(0);
+    for (size_t i = 0; i < id; ++i) {
+        const auto d = static_cast<float>(problem.cityDistance(id, i));
+        bool inserted = g.degree(i) == 0;
+        for (uint32_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e) {
+            if (!inserted && d < g.dists[e]) {
+                updated.neighbors.push_back(id);
+                updated.dists.push_back(d);
+                inserted = true;
+            }
+            updated.neighbors.push_back(g.neighbors[e]);
+            updated.dists.push_back(g.dists[e]);
+        }
+        updated.offsets.push_back(static_cast<uint32_t>(updated.neighbors.size()));
+    }
+    for (size_t e = 0; e < keep; ++e) {
+        updated.neighbors.push_back(nearest[e].second);
+        updated.dists.push_back(nearest[e].first);
+    }
+    updated.offsets.push_back(static_cast<uint32_t>(updated.neighbors.size()));
+    g = std::move(updated);
+}
+
+// Matriz (n + 1) x (n + 1): reaproveita as linhas existentes e calcula
+// apenas a linha/coluna da nova cidade, a ultima do problema.
+template <typename T>
+inline void growMatrix(std::vector<T> &matrix, const Problem &problem) {
+    const size_t n = problem.numCities() - 1;
+    std::vector<T> m((n + 1) * (n + 1));
+    for (size_t i = 0; i < n; ++i) {
+        std::memcpy(&m[i * (n + 1)], &matrix[i * n], n * sizeof(T));
+        const auto d = static_cast<T>(problem.cityDistance(n, i));
+        m[i * (n + 1) + n] = d;
+        m[n * (n + 1) + i] = d;
+    }
+    m[n * (n + 1) + n] = 0;
+    matrix.swap(m);
+}
+
+// Matriz (n - 1) x (n - 1) sem a cidade `id`; a ultima ocupa o lugar dela.
+template <typename T>
+inline void shrinkMatrix(std::vector<T> &matrix, const size_t n, const CityId id) {
+    const auto last = static_cast<CityId>(n - 1);
+    std::vector<T> m((n - 1) * (n - 1));
+    for (size_t i = 0; i + 1 < n; ++i) {
+        const size_t src = i == id ? last : i;
+        const T *row = &matrix[src * n];
+        std::memcpy(&m[i * (n - 1)], row, (n - 1) * sizeof(T));
+        if (id != last) m[i * (n - 1) + id] = row[last];
+    }
+    if (id != last) m[static_cast<size_t>(id) * (n - 1) + id] = 0;
+    matrix.swap(m);
+}
+
+inline CityId addCity(Problem &problem, const City &city) {
+    if (problem.externalMatrix) throw std::runtime_error("addCity: the distance matrix is borrowed.");
+    const auto id = static_cast<CityId>(problem.numCities());
+    problem.cities.push_back(city);
+
+    if (!problem.distanceMatrix.empty()) growMatrix(problem.distanceMatrix, problem);
+    if (!problem.intDistanceMatrix.empty()) growMatrix(problem.intDistanceMatrix, problem);
+    if (!problem.candidates.empty()) addCandidates(problem, id);
+    return id;
+}
+
+// Remove a cidade `id`; a ultima cidade (indice devolvido) passa a ser `id`.
+inline CityId removeCity(Problem &problem, const CityId id) {
+    if (problem.externalMatrix) throw std::runtime_error("removeCity: the distance matrix is borrowed.");
+    const size_t n = problem.numCities();
+    if (id >= n) throw std::runtime_error("removeCity: no such city.");
+    const auto last = static_cast<CityId>(n - 1);
+    auto rename = [&](const CityId c) { return c == last ? id : c; };
+
+    if (!problem.distanceMatrix.empty()) shrinkMatrix(problem.distanceMatrix, n, id);
+    if (!problem.intDistanceMatrix.empty()) shrinkMatrix(problem.intDistanceMatrix, n, id);
+
+    if (!problem.candidates.empty()) {
+        const CandidateGraph &g = problem.candidates;
+        CandidateGraph updated;
+        updated.offsets.reserve(n);
+        updated.neighbors.reserve(g.neighbors.size());
+        updated.dists.reserve(g.dists.size());
+        updated.offsets.push_back(0);
+        for (size_t i = 0; i + 1 < n; ++i) {
+            const size_t src = i == id ? last : i;
+            for (uint32_t e = g.offsets[src]; e < g.offsets[src + 1]; ++e) {
+                if (g.neighbors[e] == id) continue;
+                updated.neighbors.push_back(rename(g.neighbors[e]));
+                updated.dists.push_back(g.dists[e]);
+            }
+            updated.offsets.push_back(static_cast<uint32_t>(updated.neighbors.size()));
+        }
+        problem.candidates = std::move(updated);
+    }
+
+    problem.cities[id] = problem.cities[last];
+    problem.cities.pop_back();
+    return last;
+}
+
+// Insercao mais barata da cidade `id` no tour.
+inline void insertCheapest(Path &path, const Problem &problem, const CityId id) {
+    const size_t m = path.order.size();
+    if (m < 2) {
+        path.order.push_back(id);
+        return;
+    }
+    double best = std::numeric_limits<double>::infinity();
+    size_t at = 0;
+    for (size_t i = 0; i < m; ++i) {
+        const CityId a = path.order[i], b = path.order[(i + 1) % m];
+        const double delta = problem.distance(a, id) + problem.distance(id, b) - problem.distance(a, b);
+        if (delta < best) {
+            best = delta;
+            at = i + 1;
+        }
+    }
+    path.order.insert(path.order.begin() + static_cast<std::ptrdiff_t>(at), id);
+}
+
+// Retira `id` do tour (ligando seus vizinhos) e renomeia `moved` para `id`.
+inline void removeFromPath(Path &path, const CityId id, const CityId moved) {
+    const auto at = std::find(path.order.begin(), path.order.end(), id);
+    if (at == path.order.end()) throw std::runtime_error("removeFromPath: city not in the tour.");
+    path.order.erase(at);
+    if (moved == id) return;
+    const auto last = std::find(path.order.begin(), path.order.end(), moved);
+    if (last == path.order.end()) throw std::runtime_error("removeFromPath: moved city not in the tour.");
+    *last = id;
+}
+
+// Os reparos abaixo rodam depois de addCity/removeCity no Problem, que e
+// compartilhado pelos solvers (o AnnealingState so aponta para ele).
+
+// Continua o SA a partir do tour atual reparado, mantendo a temperatura.
+inline void insertCity(AnnealingState &state, const CityId id) {
+    const Problem &problem = *state.problem;
+    insertCheapest(state.currentPath, problem, id);
+    insertCheapest(state.bestPath, problem, id);
+    state.currentPath.dist = routeLength(state.currentPath.order, problem);
+    state.bestPath.dist = routeLength(state.bestPath.order, problem);
+    state.bestDist = state.bestPath.dist;
+    state.stallCounter = 0;
+}
+
+inline void eraseCity(AnnealingState &state, const CityId id, const CityId moved) {
+    const Problem &problem = *state.problem;
+    removeFromPath(state.currentPath, id, moved);
+    removeFromPath(state.bestPath, id, moved);
+    state.currentPath.dist = routeLength(state.currentPath.order, problem);
+    state.bestPath.dist = routeLength(state.bestPath.order, problem);
+    state.bestDist = state.bestPath.dist;
+    state.stallCounter = 0;
+}
+
+// Repara toda a populacao e a elite; o GA segue da geracao em que estava.
+inline void refreshGA(GAState &state, const Problem &problem) {
+    evaluate(state.population, problem);
+    sortPopulation(state.population);
+    state.bestPath.dist = routeLength(state.bestPath.order, problem);
+    if (!state.population.empty() && state.population.front().dist < state.bestPath.dist)
+        state.bestPath = state.population.front();
+    state.stallCounter = 0;
+}
+
+inline void insertCity(GAState &state, const Problem &problem, const CityId id) {
+    for (auto &path : state.population) insertCheapest(path, problem, id);
+    insertCheapest(state.bestPath, problem, id);
+    refreshGA(state, problem);
+}
+
+inline void eraseCity(GAState &state, const Problem &problem, const CityId id, const CityId moved) {
+    for (auto &path : state.population) removeFromPath(path, id, moved);
+    removeFromPath(state.bestPath, id, moved);
+    refreshGA(state, problem);
+}
+
+#endif //SALEMAN_DYNAMIC_H
@@ -0,0 +1,31 @@
+#ifndef SALEMAN_EVENTS_H
+#define SALEMAN_EVENTS_H
+#include <cstdint>
+#include <functional>
+
+#include "map.h"
+
+// Eventos dos solvers para quem os chama: callbacks na thread do solver.
+// Devolver false encerra a execucao com o melhor tour atual (regras de
+// parada do chamador).
+
+struct SolverObserver {
+    std::function<bool(const Path &best, uint64_t step)> onImprovement;
+    std::function<bool(uint64_t generation, double best, uint64_t stall)> onGeneration;
+    std::function<bool(uint64_t iterations, double temperature, double best, double current)> onTemperature;
+};
+
+// Chamadas seguras com observer nulo ou callback vazio; false = parar.
+inline bool notifyImprovement(const SolverObserver *o, const Path &best, const uint64_t step) {
+    return !o || !o->onImprovement || o->onImprovement(best, step);
+}
+inline bool notifyGeneration(const SolverObserver *o, const uint64_t generation, const double best,
+                             const uint64_t stall) {
+    return !o || !o->onGeneration || o->onGeneration(generation, best, stall);
+}
+inline bool notifyTemperature(const SolverObserver *o, const uint64_t iterations, const double temperature,
+                              const double best, const double current) {
+    return !o || !o->onTemperature || o->onTemperature(iterations, temperature, best, current);
+}
+
+#endif //SALEMAN_EVENTS_H
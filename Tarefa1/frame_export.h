@@ -0,0 +1,265 @@
+#ifndef SALEMAN_FRAME_EXPORT_H
+#define SALEMAN_FRAME_EXPORT_H
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "raster.h"
+
+// Exportacao de quadros do rasterizador como sequencia de PNG. O codificador
+// nao depende de zlib: deflate com Huffman fixo e LZ77 guloso, suficiente
+// para quadros com grandes areas de cor uniforme.
+
+inline uint32_t crc32Png(const uint8_t *data, const size_t size, uint32_t crc = 0xFFFFFFFFu) noexcept {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+// Stream zlib (RFC 1950/1951) com um unico bloco de Huffman fixo.
+inline std::vector<uint8_t> deflateFixed(const std::vector<uint8_t> &in) {
+    std::vector<uint8_t> out{0x78, 0x01};
+    uint32_t bitBuf = 0;
+    int bitCount = 0;
+    auto bits = [&](const uint32_t value, const int count) {
+        bitBuf |= value << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            out.push_back(static_cast<uint8_t>(bitBuf));
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    };
+    // codigos de Huffman vao do bit mais significativo para o menos
+    auto huffman = [&](const uint32_t code, const int length) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) reversed |= ((code >> i) & 1) << (length - 1 - i);
+        bits(reversed, length);
+    };
+    auto literal = [&](const uint32_t v) {
+        if (v < 144)
+            huffman(0x30 + v, 8);
+        else if (v < 256)
+            huffman(0x190 + v - 144, 9);
+        else if (v < 280)
+            huffman(v - 256, 7);
+        else
+            huffman(0xC0 + v - 280, 8);
+    };
+    static constexpr uint16_t lengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static constexpr uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static constexpr uint16_t distBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                              33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                              1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static constexpr uint8_t distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                              6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    bits(1, 1); // BFINAL
+    bits(1, 2); // BTYPE = 01, Huffman fixo
+    constexpr size_t window = 32768, maxLength = 258, hashSize = 1 << 15;
+    std::vector<int64_t> head(hashSize, -1);
+    const size_t n = in.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t bestLength = 0, bestDist = 0;
+        if (i + 3 <= n) {
+            const uint32_t h = ((in[i] << 10) ^ (in[i + 1] << 5) ^ in[i + 2]) & (hashSize - 1);
+            const int64_t candidate = head[h];
+            head[h] = static_cast<int64_t>(i);
+            if (candidate >= 0 && i - static_cast<size_t>(candidate) <= window) {
+                const size_t limit = std::min(maxLength, n - i);
+                size_t length = 0;
+                while (length < limit && in[candidate + length] == in[i + length]) ++length;
+                if (length >= 3) {
+                    bestLength = length;
+                    bestDist = i - static_cast<size_t>(candidate);
+                }
+            }
+        }
+        if (bestLength == 0) {
+            literal(in[i++]);
+            continue;
+        }
+        int code = 28;
+        while (lengthBase[code] > bestLength) --code;
+        literal(257 + code);
+        bits(static_cast<uint32_t>(bestLength - lengthBase[code]), lengthExtra[code]);
+        int dcode = 29;
+        while (distBase[dcode] > bestDist) --dcode;
+        huffman(static_cast<uint32_t>(dcode), 5);
+        bits(static_cast<uint32_t>(bestDist - distBase[dcode]), distExtra[dcode]);
+        i += bestLength;
+    }
+    literal(256);
+    if (bitCount > 0) bits(0, 8 - bitCount);
+
+    uint32_t a = 1, b = 0;
+    for (const uint8_t v : in) {
+        a = (a + v) % 65521;
+        b = (b + a) % 65521;
+    }
+    const uint32_t adler = b << 16 | a;
+    for (int s = 24; s >= 0; s -= 8) out.push_back(static_cast<uint8_t>(adler >> s));
+    return out;
+}
+
+// PNG RGBA de 8 bits. Cada linha usa o filtro Sub, que transforma areas de cor
+// uniforme em zeros e deixa o LZ77 bem mais eficaz.
+inline std::vector<uint8_t> encodePNG(const Canvas &canvas) {
+    const size_t stride = static_cast<size_t>(canvas.width) * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * canvas.height);
+    for (int y = 0; y < canvas.height; ++y) {
+        const uint8_t *row = &canvas.pixels[y * stride];
+        raw.push_back(1);
+        for (size_t x = 0; x < stride; ++x) raw.push_back(static_cast<uint8_t>(row[x] - (x >= 4 ? row[x - 4] : 0)));
+    }
+
+    std::vector<uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    auto be32 = [](std::vector<uint8_t> &v, const uint32_t x) {
+        for (int s = 24; s >= 0; s -= 8) v.push_back(static_cast<uint8_t>(x >> s));
+    };
+    auto chunk = [&](const char *type, const std::vector<uint8_t> &data) {
+        be32(png, static_cast<uint32_t>(data.size()));
+        const size_t start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        be32(png, crc32Png(&png[start], png.size() - start) ^ 0xFFFFFFFFu);
+    };
+    std::vector<uint8_t> ihdr;
+    be32(ihdr, static_cast<uint32_t>(canvas.width));
+    be32(ihdr, static_cast<uint32_t>(canvas.height));
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0}); // 8 bits, RGBA, deflate, filtro adaptativo, sem entrelacamento
+    chunk("IHDR", ihdr);
+    chunk("IDAT", deflateFixed(raw));
+    chunk("IEND", {});
+    return png;
+}
+
+// Grava quadros como dir/frame_000000.png numa thread propria. due() limita a
+// taxa de amostragem; se o codificador ficar para tras, submit() descarta o
+// quadro em vez de bloquear quem desenha. O diretorio e criado (ou conferido)
+// no construtor; falhas de gravacao depois disso contam a parte dos descartes.
+class FrameRecorder {
+public:
+    FrameRecorder(std::string directory, const double framesPerSecond, const size_t maxQueued = 4)
+        : directory(prepareDirectory(std::move(directory))), maxQueued(maxQueued), interval(frameInterval(framesPerSecond)),
+          encoder([this]() { drain(); }) {}
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    ~FrameRecorder() { close(); }
+
+    // Codifica o que ainda estiver na fila e encerra a thread.
+    void close() {
+        if (!encoder.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            stopping = true;
+        }
+        cv.notify_one();
+        encoder.join();
+    }
+
+    // Verdadeiro quando ja passou o intervalo desde o ultimo quadro aceito.
+    [[nodiscard]] bool due() const { return std::chrono::steady_clock::now() >= next; }
+
+    void submit(Canvas &&frame) {
+        next = std::chrono::steady_clock::now() + interval;
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            if (pending.size() >= maxQueued) {
+                ++dropped;
+                return;
+            }
+            pending.push_back(std::move(frame));
+        }
+        cv.notify_one();
+    }
+
+    [[nodiscard]] size_t written() const {
+        std::lock_guard<std::mutex> lk(mutex);
+        return count;
+    }
+    // Quadros descartados com a fila cheia.
+    [[nodiscard]] size_t droppedFrames() const {
+        std::lock_guard<std::mutex> lk(mutex);
+        return dropped;
+    }
+    // Quadros codificados que nao puderam ser gravados.
+    [[nodiscard]] size_t failedWrites() const {
+        std::lock_guard<std::mutex> lk(mutex);
+        return failed;
+    }
+
+private:
+    const std::string directory;
+    const size_t maxQueued;
+    const std::chrono::steady_clock::duration interval;
+    std::chrono::steady_clock::time_point next{};
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Canvas> pending;
+    bool stopping = false;
+    size_t count = 0, dropped = 0, failed = 0;
+    std::thread encoder; // por ultimo: so inicia com os demais membros prontos
+
+    static std::string prepareDirectory(std::string directory) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec || !std::filesystem::is_directory(directory, ec))
+            throw std::runtime_error("FrameRecorder: cannot create directory " + directory + ".");
+        return directory;
+    }
+
+    static std::chrono::steady_clock::duration frameInterval(const double framesPerSecond) {
+        if (!(framesPerSecond > 0.0)) throw std::runtime_error("FrameRecorder: frame rate must be positive.");
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / framesPerSecond));
+    }
+
+    void drain() {
+        std::unique_lock<std::mutex> lk(mutex);
+        while (true) {
+            cv.wait(lk, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) break;
+            Canvas frame = std::move(pending.front());
+            pending.pop_front();
+            const size_t index = count;
+            lk.unlock();
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%06zu.png", index);
+            const std::vector<uint8_t> png = encodePNG(frame);
+            std::ofstream out(directory + name, std::ios::binary);
+            out.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+            const bool ok = static_cast<bool>(out);
+
+            lk.lock();
+            ++(ok ? count : failed);
+        }
+    }
+};
+
+#endif //SALEMAN_FRAME_EXPORT_H
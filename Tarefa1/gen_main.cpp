@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+
+#include "generator.h"
+#include "instance_io.h"
+
+namespace {
+
+Metric parseMetric(const std::string &name)
+{
+    if (name == "euclidean") return Metric::Euclidean;
+    if (name == "euc2d") return Metric::Euc2D;
+    if (name == "ceil2d") return Metric::Ceil2D;
+    throw std::runtime_error("Unknown metric " + name + " (expected euclidean, euc2d or ceil2d).");
+}
+
+bool endsWith(const std::string &s, const std::string &suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+// saleman_gen [--dist uniform|clustered|grid|road] [--cities n] [--width w] [--height h] [--seed s]
+//             [--clusters k] [--sigma f] [--jitter f] [--roads k] [--segments k] [--road-width f]
+//             [--metric euclidean|euc2d|ceil2d] [--threads t] [--format binary|tsplib] [--name nome] saida
+// Sem --format, saidas .tsp vao em TSPLIB e as demais no formato binario
+// (readInstance le os dois). A mesma semente gera a mesma instancia com
+// qualquer numero de threads.
+int main(int argc, char** argv)
+{
+    GeneratorParams params;
+    Metric metric = Metric::Euc2D;
+    std::string format, name, output;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--dist") == 0 && hasValue) params.distribution = parseDistribution(argv[++i]);
+            else if (std::strcmp(argv[i], "--cities") == 0 && hasValue) params.numCities = std::stoull(argv[++i]);
+            else if (std::strcmp(argv[i], "--width") == 0 && hasValue) params.width = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--height") == 0 && hasValue) params.height = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) params.seed = std::stoull(argv[++i]);
+            else if (std::strcmp(argv[i], "--clusters") == 0 && hasValue) params.clusters = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--sigma") == 0 && hasValue) params.clusterSigma = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--jitter") == 0 && hasValue) params.jitter = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--roads") == 0 && hasValue) params.roads = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--segments") == 0 && hasValue) params.roadSegments = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--road-width") == 0 && hasValue) params.roadWidth = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--metric") == 0 && hasValue) metric = parseMetric(argv[++i]);
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) params.threads = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--format") == 0 && hasValue) format = argv[++i];
+            else if (std::strcmp(argv[i], "--name") == 0 && hasValue) name = argv[++i];
+            else if (argv[i][0] != '-' && output.empty()) output = argv[i];
+            else throw std::runtime_error(std::string("unknown argument ") + argv[i] + ".");
+        }
+        if (output.empty()) throw std::runtime_error("missing output file.");
+        if (params.threads == 0) throw std::runtime_error("--threads must be positive.");
+        if (format.empty()) format = endsWith(output, ".tsp") ? "tsplib" : "binary";
+        if (format != "binary" && format != "tsplib") throw std::runtime_error("--format must be binary or tsplib.");
+        if (name.empty()) name = std::string(distributionName(params.distribution)) + std::to_string(params.numCities);
+
+        const auto start = std::chrono::steady_clock::now();
+        Problem problem;
+        problem.metric = metric;
+        generateInstance(problem, params);
+        const double generated = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (format == "tsplib")
+        {
+            if (metric == Metric::Euclidean) throw std::runtime_error("TSPLIB output needs --metric euc2d or ceil2d.");
+            writeTSPLIB(output, problem, name);
+        }
+        else
+        {
+            writeBinaryInstance(output, problem);
+        }
+        const double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s: %zu %s cities in %ux%u (seed %llu), generated in %.3f s, written in %.3f s\n",
+                    output.c_str(), problem.numCities(), distributionName(params.distribution), params.width,
+                    params.height, static_cast<unsigned long long>(params.seed), generated, total - generated);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_gen: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+#ifndef SALEMAN_GENERATOR_H
+#define SALEMAN_GENERATOR_H
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "map.h"
+
+// Instancias sinteticas alem da uniforme de populateCities: clusters
+// gaussianos, grade com ruido e "estradas" (pontos ao longo de polilinhas).
+// O resultado depende so dos parametros e da semente, nao do numero de
+// threads: as cidades saem em blocos de generatorChunk, cada bloco com seu
+// proprio gerador derivado de (seed, bloco), e a estrutura (centros,
+// polilinhas) vem de um gerador a parte.
+
+enum class Distribution { Uniform, Clustered, Grid, Road };
+
+inline const char *distributionName(const Distribution d) {
+    switch (d) {
+    case Distribution::Uniform: return "uniform";
+    case Distribution::Clustered: return "clustered";
+    case Distribution::Grid: return "grid";
+    default: return "road";
+    }
+}
+
+inline Distribution parseDistribution(const std::string &name) {
+    for (const Distribution d : {Distribution::Uniform, Distribution::Clustered, Distribution::Grid, Distribution::Road})
+        if (name == distributionName(d)) return d;
+    throw std::runtime_error("Unknown distribution " + name + " (expected uniform, clustered, grid or road).");
+}
+
+struct GeneratorParams {
+    Distribution distribution = Distribution::Uniform;
+    size_t numCities = 1000;
+    unsigned int width = 10000, height = 10000;
+    uint64_t seed = 1;
+    size_t clusters = 0;         // 0: sqrt(n) / 2
+    double clusterSigma = 0.02;  // desvio medio, em fracao do lado menor
+    double jitter = 0.5;         // ruido da grade, em fracao da celula (1 = uniforme na celula)
+    size_t roads = 0;            // 0: cbrt(n)
+    size_t roadSegments = 24;    // segmentos por polilinha
+    double roadWidth = 0.002;    // desvio lateral, em fracao do lado menor
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+inline constexpr size_t generatorChunk = size_t{1} << 16;
+
+// splitmix64 com transformacoes proprias: std::*_distribution nao e igual
+// entre bibliotecas, e a instancia tem de ser a mesma em qualquer maquina.
+struct GeneratorRng {
+    uint64_t state;
+
+    explicit GeneratorRng(const uint64_t seed, const uint64_t stream) : state(seed) {
+        state = next() ^ (stream * 0xd1b54a32d192ed03ull);
+    }
+    uint64_t next() noexcept {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    double uniform() noexcept { return static_cast<double>(next() >> 11) * 0x1.0p-53; } // [0, 1)
+    double normal() noexcept { // Box-Muller
+        const double u = 1.0 - uniform(), v = uniform();
+        return std::sqrt(-2.0 * std::log(u)) * std::cos(6.283185307179586 * v);
+    }
+};
+
+namespace generator_detail {
+
+struct Cluster {
+    double x, y, sigma;
+};
+
+struct Segment {
+    double ax, ay, bx, by;
+};
+
+// Estrutura sorteada antes das cidades: centros com peso e espalhamento
+// variados, ou polilinhas que andam pela janela como passeios com inercia.
+struct Layout {
+    std::vector<Cluster> clusters;
+    std::vector<double> clusterWeights; // acumulados
+    std::vector<Segment> segments;
+    std::vector<double> segmentLengths; // acumulados
+};
+
+inline Layout buildLayout(const GeneratorParams &p) {
+    Layout layout;
+    GeneratorRng rng(p.seed, 0);
+    const double w = p.width, h = p.height, side = std::min(w, h);
+    if (p.distribution == Distribution::Clustered) {
+        const size_t k = p.clusters ? p.clusters
+                                    : std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(p.numCities)) / 2.0));
+        double total = 0.0;
+        for (size_t c = 0; c < k; ++c) {
+            layout.clusters.push_back({rng.uniform() * w, rng.uniform() * h,
+                                       p.clusterSigma * side * std::exp(rng.normal() * 0.5)});
+            total += 0.2 + rng.uniform();
+            layout.clusterWeights.push_back(total);
+        }
+    } else if (p.distribution == Distribution::Road) {
+        const size_t k = p.roads ? p.roads
+                                 : std::max<size_t>(1, static_cast<size_t>(std::cbrt(static_cast<double>(p.numCities))));
+        const double step = side / static_cast<double>(std::max<size_t>(4, p.roadSegments / 2));
+        double total = 0.0;
+        for (size_t r = 0; r < k; ++r) {
+            double x = rng.uniform() * w, y = rng.uniform() * h;
+            double heading = rng.uniform() * 6.283185307179586;
+            for (size_t s = 0; s < p.roadSegments; ++s) {
+                heading += rng.normal() * 0.35;
+                const double len = step * (0.5 + rng.uniform());
+                double nx = x + std::cos(heading) * len, ny = y + std::sin(heading) * len;
+                // na borda a estrada volta para dentro
+                if (nx < 0.0 || nx > w - 1.0 || ny < 0.0 || ny > h - 1.0) {
+                    heading += 3.141592653589793;
+                    nx = std::clamp(nx, 0.0, w - 1.0);
+                    ny = std::clamp(ny, 0.0, h - 1.0);
+                }
+                const double segLen = std::hypot(nx - x, ny - y);
+                if (segLen > 0.0) {
+                    layout.segments.push_back({x, y, nx, ny});
+                    total += segLen;
+                    layout.segmentLengths.push_back(total);
+                }
+                x = nx;
+                y = ny;
+            }
+        }
+        if (layout.segments.empty()) throw std::runtime_error("Generator: map too small for roads.");
+    }
+    return layout;
+}
+
+inline size_t pickCumulative(const std::vector<double> &cumulative, const double u) {
+    const size_t i = static_cast<size_t>(
+        std::upper_bound(cumulative.begin(), cumulative.end(), u * cumulative.back()) - cumulative.begin());
+    return std::min(i, cumulative.size() - 1);
+}
+
+inline void generateChunk(const GeneratorParams &p, const Layout &layout, std::vector<City> &cities,
+                          const size_t chunk) {
+    GeneratorRng rng(p.seed, chunk + 1);
+    const double w = p.width, h = p.height, side = std::min(w, h);
+    const size_t begin = chunk * generatorChunk, end = std::min(cities.size(), begin + generatorChunk);
+    // grade com cols x rows >= n celulas na proporcao da janela
+    const size_t cols = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(cities.size()) * w / h))));
+    const size_t rows = (cities.size() + cols - 1) / cols;
+    const double cellW = w / static_cast<double>(cols), cellH = h / static_cast<double>(rows);
+
+    for (size_t i = begin; i < end; ++i) {
+        double x = 0.0, y = 0.0;
+        switch (p.distribution) {
+        case Distribution::Uniform:
+            x = rng.uniform() * w;
+            y = rng.uniform() * h;
+            break;
+        case Distribution::Clustered: {
+            const Cluster &c = layout.clusters[pickCumulative(layout.clusterWeights, rng.uniform())];
+            // reamostra algumas vezes antes de prender na borda
+            for (int attempt = 0; attempt < 8; ++attempt) {
+                x = c.x + rng.normal() * c.sigma;
+                y = c.y + rng.normal() * c.sigma;
+                if (x >= 0.0 && x < w && y >= 0.0 && y < h) break;
+            }
+            break;
+        }
+        case Distribution::Grid:
+            x = (static_cast<double>(i % cols) + 0.5 + (rng.uniform() - 0.5) * p.jitter) * cellW;
+            y = (static_cast<double>(i / cols) + 0.5 + (rng.uniform() - 0.5) * p.jitter) * cellH;
+            break;
+        default: {
+            const size_t s = pickCumulative(layout.segmentLengths, rng.uniform());
+            const Segment &seg = layout.segments[s];
+            const double t = rng.uniform();
+            const double dx = seg.bx - seg.ax, dy = seg.by - seg.ay, len = std::hypot(dx, dy);
+            const double off = rng.normal() * p.roadWidth * side;
+            x = seg.ax + t * dx - dy / len * off;
+            y = seg.ay + t * dy + dx / len * off;
+            break;
+        }
+        }
+        cities[i].x = static_cast<unsigned int>(std::clamp(x, 0.0, w - 1.0));
+        cities[i].y = static_cast<unsigned int>(std::clamp(y, 0.0, h - 1.0));
+        cities[i].tag = static_cast<CityId>(i);
+    }
+}
+
+} // namespace generator_detail
+
+// Preenche problem.cities e problem.map; metrica e matrizes ficam como estao.
+inline void generateInstance(Problem &problem, const GeneratorParams &params) {
+    if (params.width == 0 || params.height == 0) throw std::runtime_error("Generator: empty map.");
+    if (params.numCities > std::numeric_limits<CityId>::max()) throw std::runtime_error("Generator: too many cities.");
+    const generator_detail::Layout layout = generator_detail::buildLayout(params);
+    initializeMap(problem.map, params.width, params.height);
+    problem.cities.assign(params.numCities, City());
+
+    const size_t chunks = (params.numCities + generatorChunk - 1) / generatorChunk;
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t c = next++; c < chunks; c = next++)
+            generator_detail::generateChunk(params, layout, problem.cities, c);
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < std::min(params.threads, chunks); ++t) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+}
+
+#endif //SALEMAN_GENERATOR_H
@@ -1,8 +1,13 @@
 #ifndef SALEMAN_GENETIC_H
 #define SALEMAN_GENETIC_H
+#include <algorithm>
+#include <chrono>
 #include <numeric>
+#include <stdexcept>
 
 #include "annealing.h"
+#include "events.h"
+#include "kernels.h"
 #include "map.h"
 
 struct GAParams {
@@ -13,19 +18,34 @@ struct GAParams {
     size_t elitism = 5;
     size_t stallLimit = 100;
 	size_t numMutations = 1;
+    // initGA e stepGA param no meio quando o prazo passa (buscas com tempo)
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
 };
 
+// Populacao proporcional ao tamanho, limitada a 1000 individuos.
+inline GAParams defaultGAParams(const size_t n) {
+  GAParams p;
+  p.populationSize = std::min<size_t>(10 * n, 1000);
+  p.elitism = std::max<size_t>(1, p.populationSize * 3 / 100);
+  p.tournamentK = std::max<size_t>(2, p.populationSize / 1000);
+  p.mutationRate = 0.1;
+  p.stallLimit = 250;
+  return p;
+}
+
+inline void randomTour(Path &path, const std::vector<CityId> &base, RNG &rng) {
+  path.order = base;
+  for (size_t i = base.size() - 1; i > 0; --i) {
+    const size_t j = rng.randint(0, i);
+    std::swap(path.order[i], path.order[j]);
+  }
+  path.dist = std::numeric_limits<double>::infinity();
+}
+
 inline void initPopulation(std::vector<Path> &pop, const size_t nCities, RNG &rng) {
-  std::vector<uint16_t> base(nCities);
+  std::vector<CityId> base(nCities);
   std::iota(base.begin(), base.end(), 0);
-  for (auto &path : pop) {
-    path.order = base;
-    for (size_t i = nCities - 1; i > 0; --i) {
-      const size_t j = rng.randint(0, i);
-      std::swap(path.order[i], path.order[j]);
-    }
-    path.dist = std::numeric_limits<double>::infinity();
-  }
+  for (auto &path : pop) randomTour(path, base, rng);
 }
 
 inline size_t tournamentSelect(const std::vector<Path> &pop, RNG &rng,
@@ -42,27 +62,29 @@ inline size_t tournamentSelect(const std::vector<Path> &pop, RNG &rng,
 inline void orderCrossover(const Path &p1, const Path &p2,
                            Path &child, RNG &rng) {
   const size_t n = p1.order.size();
-  child.order.assign(n, std::numeric_limits<uint16_t>::max());
+  child.order.resize(n);
   size_t a = rng.randint(0, n - 1);
   size_t b = rng.randint(0, n - 1);
   if (a > b)
     std::swap(a, b);
 
-  std::vector<char> taken(n, false);
+  // folgas exigidas por compactUntaken (gathers de 4 bytes e stores de vetor cheio)
+  std::vector<uint8_t> taken(n + 3, 0);
   for (size_t i = a; i <= b; ++i) {
-    const uint16_t gene = p1.order[i];
+    const CityId gene = p1.order[i];
     child.order[i] = gene;
-    taken[gene] = true;
+    taken[gene] = 1;
   }
 
-  size_t pos = (b + 1) % n;
-  for (size_t i = 0; i < n; ++i) {
-    const uint16_t gene = p2.order[(b + 1 + i) % n];
-    if (!taken[gene]) {
-      child.order[pos] = gene;
-      pos = (pos + 1) % n;
-    }
-  }
+  // genes de p2, a partir de b+1 em ordem circular, que nao vieram de p1
+  std::vector<CityId> rest(n + 16);
+  const KernelTable &k = kernels();
+  size_t count = k.compactUntaken(p2.order.data() + b + 1, n - b - 1, taken.data(), rest.data());
+  count += k.compactUntaken(p2.order.data(), b + 1, taken.data(), rest.data() + count);
+
+  const size_t tail = std::min(count, n - b - 1);
+  std::copy(rest.begin(), rest.begin() + tail, child.order.begin() + b + 1);
+  std::copy(rest.begin() + tail, rest.begin() + count, child.order.begin());
 }
 
 inline void mutateSwap(Path &ind, const double mutationRate, size_t numMutations, RNG &rng) {
@@ -84,50 +106,150 @@ inline void evaluate(std::vector<Path> &pop, const std::vector<double> &distM) {
   }
 }
 
-inline Path runGA(Problem &problem, const GAParams &cfg, RNG &rng) {
+inline void evaluate(Path *pop, const size_t count, const Problem &problem) {
   const size_t n = problem.numCities();
-  if (n < 3)
-    throw std::runtime_error("Need at least 3 cities.");
+  const int32_t *intM = problem.intDistanceMatrix.empty() ? nullptr : problem.intDistanceMatrix.data();
+  const double *distM = problem.denseDistances();
+  if ((!intM && !distM) || !batchPays(n) || count < 8) {
+    for (size_t i = 0; i < count; ++i) {
+      pop[i].dist = routeLength(pop[i].order, problem);
+    }
+    return;
+  }
+
+  // todos os tours tem o mesmo tamanho: pontua em lote com SIMD, na matriz
+  // int32 quando houver (como routeLength)
+  std::vector<const CityId *> tours(count);
+  for (size_t i = 0; i < count; ++i) tours[i] = pop[i].order.data();
+  if (intM) {
+    std::vector<int64_t> lengths(count);
+    kernels().routeLengthBatchInt(tours.data(), count, n, intM, lengths.data());
+    for (size_t i = 0; i < count; ++i) pop[i].dist = static_cast<double>(lengths[i]);
+    return;
+  }
+  std::vector<double> dists(count);
+  routeLengthBatch(tours.data(), count, n, distM, dists.data());
+  for (size_t i = 0; i < count; ++i) pop[i].dist = dists[i];
+}
 
-  problem.distanceMatrix = buildDistanceMatrix(problem);
+inline void evaluate(std::vector<Path> &pop, const Problem &problem) {
+  evaluate(pop.data(), pop.size(), problem);
+}
 
-  std::vector<Path> pop(cfg.populationSize);
-  initPopulation(pop, n, rng);
-  evaluate(pop, problem.distanceMatrix);
-  std::sort(pop.begin(), pop.end(),
-            [](const auto &a, const auto &b) { return a.dist < b.dist; });
+// Individuos criados e pontuados entre duas consultas ao prazo. Em instancias
+// esparsas um so tour aleatorio custa n acessos fora da cache, e uma geracao
+// inteira pode passar do orcamento.
+inline constexpr size_t gaDeadlineBlock = 64;
 
-  Path best = pop.front();
+inline bool gaExpired(const GAParams &cfg) {
+  return cfg.deadline != std::chrono::steady_clock::time_point::max() &&
+         std::chrono::steady_clock::now() >= cfg.deadline;
+}
+
+struct GAState {
+  std::vector<Path> population;
+  std::vector<Path> next;
+  GAParams params;
+  Path bestPath;
+  size_t generation = 0;
   size_t stallCounter = 0;
+};
 
-  std::vector<Path> next(pop.size());
-  for (size_t gen = 0; gen < cfg.generations; ++gen) {
-    for (size_t e = 0; e < cfg.elitism; ++e)
-      next[e] = pop[e];
+inline void sortPopulation(std::vector<Path> &pop) {
+  std::sort(pop.begin(), pop.end(),
+            [](const auto &a, const auto &b) { return a.dist < b.dist; });
+}
+
+// Se o prazo passa no meio, a populacao fica so com os blocos ja pontuados.
+inline void initGA(GAState &state, const Problem &problem, RNG &rng) {
+  std::vector<Path> &pop = state.population;
+  pop.resize(state.params.populationSize);
+  std::vector<CityId> base(problem.numCities());
+  std::iota(base.begin(), base.end(), 0);
+  for (size_t i = 0; i < pop.size(); i += gaDeadlineBlock) {
+    if (i > 0 && gaExpired(state.params)) {
+      pop.resize(i);
+      break;
+    }
+    const size_t end = std::min(pop.size(), i + gaDeadlineBlock);
+    for (size_t k = i; k < end; ++k) randomTour(pop[k], base, rng);
+    evaluate(pop.data() + i, end - i, problem);
+  }
+  sortPopulation(pop);
+  state.next.resize(state.population.size());
+  state.bestPath = state.population.front();
+  state.generation = 0;
+  state.stallCounter = 0;
+}
 
-    for (size_t i = cfg.elitism; i < pop.size(); ++i) {
+// Uma geracao: elitismo, torneio, OX e mutacao. Retorna false quando o
+// limite de geracoes ou de estagnacao foi atingido, ou quando o prazo passa
+// no meio; nesse caso a geracao e descartada e a populacao fica como estava.
+inline bool stepGA(GAState &state, const Problem &problem, RNG &rng) {
+  const GAParams &cfg = state.params;
+  if (state.generation >= cfg.generations || state.stallCounter >= cfg.stallLimit)
+    return false;
+
+  std::vector<Path> &pop = state.population;
+  std::vector<Path> &next = state.next;
+  next.resize(pop.size());
+  const size_t elite = std::min(cfg.elitism, pop.size());
+  for (size_t e = 0; e < elite; ++e)
+    next[e] = pop[e];
+
+  // a elite ja esta pontuada; os filhos sao pontuados bloco a bloco
+  for (size_t i = elite; i < pop.size(); i += gaDeadlineBlock) {
+    if (gaExpired(cfg))
+      return false;
+    const size_t end = std::min(pop.size(), i + gaDeadlineBlock);
+    for (size_t k = i; k < end; ++k) {
       const Path &p1 = pop[tournamentSelect(pop, rng, cfg.tournamentK)];
       const Path &p2 = pop[tournamentSelect(pop, rng, cfg.tournamentK)];
-      orderCrossover(p1, p2, next[i], rng);
-      mutateSwap(next[i], cfg.mutationRate, cfg.numMutations, rng);
+      orderCrossover(p1, p2, next[k], rng);
+      mutateSwap(next[k], cfg.mutationRate, cfg.numMutations, rng);
     }
+    evaluate(next.data() + i, end - i, problem);
+  }
 
-    pop.swap(next);
-    evaluate(pop, problem.distanceMatrix);
-    std::sort(pop.begin(), pop.end(),
-              [](const auto &a, const auto &b) { return a.dist < b.dist; });
+  pop.swap(next);
+  sortPopulation(pop);
 
-    if (pop.front().dist + 1e-9 < best.dist) {
-      best = pop.front();
-      stallCounter = 0;
-    } else {
-		stallCounter++;
-    }
+  if (pop.front().dist + 1e-9 < state.bestPath.dist) {
+    state.bestPath = pop.front();
+    state.stallCounter = 0;
+  } else {
+    state.stallCounter++;
+  }
+
+  state.generation++;
+  return state.generation < cfg.generations && state.stallCounter < cfg.stallLimit;
+}
 
-    if (stallCounter >= cfg.stallLimit)
-		break;
+// Com observer, avisa cada geracao e cada melhora; false em um callback
+// encerra com o melhor individuo ate ali.
+inline Path runGA(Problem &problem, const GAParams &cfg, RNG &rng, const SolverObserver *observer = nullptr) {
+  const size_t n = problem.numCities();
+  if (n < 3)
+    throw std::runtime_error("Need at least 3 cities.");
+
+  if (problem.candidates.empty())
+    buildDenseMatrix(problem);
+
+  GAState state;
+  state.params = cfg;
+  initGA(state, problem, rng);
+  if (!notifyImprovement(observer, state.bestPath, 0))
+    return state.bestPath;
+  bool more = true;
+  while (more) {
+    const double before = state.bestPath.dist;
+    more = stepGA(state, problem, rng);
+    if (state.bestPath.dist < before && !notifyImprovement(observer, state.bestPath, state.generation))
+      break;
+    if (!notifyGeneration(observer, state.generation, state.bestPath.dist, state.stallCounter))
+      break;
   }
-  return best;
+  return state.bestPath;
 }
 
 #endif //SALEMAN_GENETIC_H
\ No newline at end of file
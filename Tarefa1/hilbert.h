@@ -0,0 +1,98 @@
+#ifndef SALEMAN_HILBERT_H
+#define SALEMAN_HILBERT_H
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "map.h"
+
+// Posicao de (x, y) ao longo de uma curva de Hilbert de lado 2^order.
+inline uint64_t hilbertIndex(const unsigned int order, uint32_t x, uint32_t y) noexcept {
+    const uint64_t side = uint64_t{1} << order;
+    uint64_t d = 0;
+    for (uint64_t s = side >> 1; s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) ? 1u : 0u;
+        const uint32_t ry = (y & s) ? 1u : 0u;
+        d += s * s * ((3u * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = static_cast<uint32_t>(side - 1 - x);
+                y = static_cast<uint32_t>(side - 1 - y);
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Indices de problem.cities ordenados ao longo da curva de Hilbert.
+inline std::vector<size_t> hilbertOrder(const Problem &problem) {
+    const size_t n = problem.numCities();
+    std::vector<size_t> idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    if (n < 2) return idx;
+
+    unsigned int minX = problem.cities[0].x, minY = problem.cities[0].y;
+    unsigned int maxX = minX, maxY = minY;
+    for (const auto &c : problem.cities) {
+        minX = std::min(minX, c.x);
+        minY = std::min(minY, c.y);
+        maxX = std::max(maxX, c.x);
+        maxY = std::max(maxY, c.y);
+    }
+    const unsigned int span = std::max(maxX - minX, maxY - minY);
+    unsigned int order = 1;
+    while (order < 32 && (uint64_t{1} << order) <= span) ++order;
+
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = hilbertIndex(order, problem.cities[i].x - minX, problem.cities[i].y - minY);
+    }
+    std::stable_sort(idx.begin(), idx.end(),
+                     [&keys](const size_t a, const size_t b) { return keys[a] < keys[b]; });
+    return idx;
+}
+
+// Renumera as cidades na ordem de Hilbert para que vizinhas geograficas fiquem
+// proximas na distanceMatrix. O campo tag preserva o identificador original.
+inline void renumberCitiesHilbert(Problem &problem) {
+    const std::vector<size_t> idx = hilbertOrder(problem);
+    std::vector<City> reordered;
+    reordered.reserve(idx.size());
+    for (const size_t i : idx) reordered.push_back(problem.cities[i]);
+    problem.cities.swap(reordered);
+
+    if (hasDenseMatrix(problem)) buildDenseMatrix(problem);
+
+    if (!problem.candidates.empty()) {
+        const CandidateGraph &old = problem.candidates;
+        std::vector<CityId> newIndex(idx.size());
+        for (size_t i = 0; i < idx.size(); ++i) newIndex[idx[i]] = static_cast<CityId>(i);
+
+        CandidateGraph g;
+        g.offsets.reserve(old.offsets.size());
+        g.neighbors.reserve(old.neighbors.size());
+        g.dists.reserve(old.dists.size());
+        g.offsets.push_back(0);
+        for (const size_t i : idx) {
+            for (uint32_t k = old.offsets[i]; k < old.offsets[i + 1]; ++k) {
+                g.neighbors.push_back(newIndex[old.neighbors[k]]);
+                g.dists.push_back(old.dists[k]);
+            }
+            g.offsets.push_back(static_cast<uint32_t>(g.neighbors.size()));
+        }
+        problem.candidates = std::move(g);
+    }
+}
+
+// Traduz um tour em indices internos para os tags originais das cidades.
+inline std::vector<CityId> toOriginalTags(const std::vector<CityId> &order,
+                                          const Problem &problem) {
+    std::vector<CityId> tags;
+    tags.reserve(order.size());
+    for (const CityId idx : order) tags.push_back(problem.cities[idx].tag);
+    return tags;
+}
+
+#endif //SALEMAN_HILBERT_H
@@ -0,0 +1,272 @@
+#ifndef SALEMAN_INSTANCE_IO_H
+#define SALEMAN_INSTANCE_IO_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "map.h"
+
+// Leitura e escrita de instancias e tours no formato TSPLIB (EUC_2D e
+// CEIL_2D) e no formato binario proprio. O tag de cada cidade guarda o numero
+// do no no arquivo menos um, entao os tours gravados continuam validos depois
+// de renumberCitiesHilbert.
+
+inline std::string trimTsplib(const std::string &s) {
+    const size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    return s.substr(b, s.find_last_not_of(" \t\r") - b + 1);
+}
+
+inline Problem readTSPLIB(std::istream &in, std::string *name = nullptr) {
+    Problem problem;
+    size_t dimension = 0;
+    bool hasMetric = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trimTsplib(line);
+        if (line.empty()) continue;
+        if (line == "EOF") break;
+        if (line.rfind("NODE_COORD_SECTION", 0) == 0) {
+            if (!hasMetric) throw std::runtime_error("TSPLIB: EDGE_WEIGHT_TYPE missing before NODE_COORD_SECTION.");
+            std::vector<double> xs, ys;
+            std::vector<CityId> ids;
+            for (size_t i = 0; i < dimension; ++i) {
+                long long id;
+                double x, y;
+                if (!(in >> id >> x >> y)) throw std::runtime_error("TSPLIB: truncated NODE_COORD_SECTION.");
+                if (id < 1 || static_cast<size_t>(id) > dimension) throw std::runtime_error("TSPLIB: node id out of range.");
+                if (x != std::floor(x) || y != std::floor(y))
+                    throw std::runtime_error("TSPLIB: fractional coordinates are not supported.");
+                ids.push_back(static_cast<CityId>(id - 1));
+                xs.push_back(x);
+                ys.push_back(y);
+            }
+            // translacao inteira para coordenadas sem sinal: as distancias nao mudam
+            const double minX = *std::min_element(xs.begin(), xs.end());
+            const double minY = *std::min_element(ys.begin(), ys.end());
+            const double maxX = *std::max_element(xs.begin(), xs.end());
+            const double maxY = *std::max_element(ys.begin(), ys.end());
+            constexpr double limit = std::numeric_limits<unsigned int>::max();
+            if (maxX - minX >= limit || maxY - minY >= limit) throw std::runtime_error("TSPLIB: coordinates out of range.");
+            problem.cities.resize(dimension);
+            for (size_t i = 0; i < dimension; ++i) {
+                City &c = problem.cities[i];
+                c.x = static_cast<unsigned int>(xs[i] - minX);
+                c.y = static_cast<unsigned int>(ys[i] - minY);
+                c.tag = ids[i];
+            }
+            initializeMap(problem.map, static_cast<unsigned int>(maxX - minX) + 1,
+                          static_cast<unsigned int>(maxY - minY) + 1);
+            continue;
+        }
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const std::string key = trimTsplib(line.substr(0, colon));
+        const std::string value = trimTsplib(line.substr(colon + 1));
+        if (key == "NAME") {
+            if (name) *name = value;
+        } else if (key == "TYPE") {
+            if (value != "TSP") throw std::runtime_error("TSPLIB: unsupported TYPE " + value + ".");
+        } else if (key == "DIMENSION") {
+            dimension = std::stoul(value);
+        } else if (key == "EDGE_WEIGHT_TYPE") {
+            if (value == "EUC_2D")
+                problem.metric = Metric::Euc2D;
+            else if (value == "CEIL_2D")
+                problem.metric = Metric::Ceil2D;
+            else
+                throw std::runtime_error("TSPLIB: unsupported EDGE_WEIGHT_TYPE " + value + ".");
+            hasMetric = true;
+        }
+    }
+    if (problem.numCities() != dimension || dimension == 0)
+        throw std::runtime_error("TSPLIB: missing or incomplete NODE_COORD_SECTION.");
+    return problem;
+}
+
+inline Problem readTSPLIB(const std::string &path, std::string *name = nullptr) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open " + path + ".");
+    return readTSPLIB(in, name);
+}
+
+// A metrica Euclidean nao existe no TSPLIB; e gravada como EUC_2D.
+inline void writeTSPLIB(std::ostream &out, const Problem &problem, const std::string &name) {
+    out << "NAME : " << name << '\n'
+        << "TYPE : TSP\n"
+        << "DIMENSION : " << problem.numCities() << '\n'
+        << "EDGE_WEIGHT_TYPE : " << (problem.metric == Metric::Ceil2D ? "CEIL_2D" : "EUC_2D") << '\n'
+        << "NODE_COORD_SECTION\n";
+    for (const City &c : problem.cities) out << c.tag + 1 << ' ' << c.x << ' ' << c.y << '\n';
+    out << "EOF\n";
+}
+
+inline void writeTSPLIB(const std::string &path, const Problem &problem, const std::string &name) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path + ".");
+    writeTSPLIB(out, problem, name);
+}
+
+// Tour .tour (TOUR_SECTION terminada por -1) convertido para indices do problema.
+inline std::vector<CityId> readTSPLIBTour(std::istream &in, const Problem &problem) {
+    const size_t n = problem.numCities();
+    constexpr CityId none = std::numeric_limits<CityId>::max();
+    std::vector<CityId> byTag(n, none);
+    for (size_t i = 0; i < n; ++i) {
+        if (problem.cities[i].tag < n) byTag[problem.cities[i].tag] = static_cast<CityId>(i);
+    }
+
+    std::string line;
+    while (std::getline(in, line) && trimTsplib(line).rfind("TOUR_SECTION", 0) != 0) {
+    }
+    std::vector<CityId> order;
+    order.reserve(n);
+    long long id;
+    while (in >> id && id != -1) {
+        if (id < 1 || static_cast<size_t>(id) > n || byTag[id - 1] == none)
+            throw std::runtime_error("TSPLIB: tour node out of range.");
+        order.push_back(byTag[id - 1]);
+    }
+    if (order.size() != n) throw std::runtime_error("TSPLIB: tour does not visit every city.");
+    return order;
+}
+
+inline std::vector<CityId> readTSPLIBTour(const std::string &path, const Problem &problem) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open " + path + ".");
+    return readTSPLIBTour(in, problem);
+}
+
+inline void writeTSPLIBTour(std::ostream &out, const std::vector<CityId> &order, const Problem &problem,
+                            const std::string &name) {
+    out << "NAME : " << name << '\n'
+        << "TYPE : TOUR\n"
+        << "DIMENSION : " << order.size() << '\n'
+        << "TOUR_SECTION\n";
+    for (const CityId c : order) out << problem.cities[c].tag + 1 << '\n';
+    out << "-1\nEOF\n";
+}
+
+inline void writeTSPLIBTour(const std::string &path, const std::vector<CityId> &order, const Problem &problem,
+                            const std::string &name) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path + ".");
+    writeTSPLIBTour(out, order, problem, name);
+}
+
+// Formato binario: InstanceHeader seguido de numCities x InstanceCity, tudo
+// little-endian. Le e grava milhoes de cidades sem converter texto.
+struct InstanceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numCities;
+    uint32_t metric; // Metric
+    uint32_t width, height;
+    uint32_t reserved;
+};
+static_assert(sizeof(InstanceHeader) == 32, "InstanceHeader layout is part of the file format");
+
+struct InstanceCity {
+    uint32_t x, y, tag;
+};
+
+inline constexpr char instanceMagic[8] = {'S', 'L', 'M', 'N', 'I', 'N', 'S', 'T'};
+inline constexpr uint32_t instanceVersion = 1;
+
+inline void writeBinaryInstance(const std::string &path, const Problem &problem) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot write " + path + ".");
+    InstanceHeader header{};
+    std::memcpy(header.magic, instanceMagic, sizeof(header.magic));
+    header.version = instanceVersion;
+    header.numCities = static_cast<uint32_t>(problem.numCities());
+    header.metric = static_cast<uint32_t>(problem.metric);
+    header.width = problem.map.width;
+    header.height = problem.map.height;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    std::vector<InstanceCity> block;
+    for (size_t i = 0; i < problem.numCities(); i += 65536) {
+        const size_t end = std::min(problem.numCities(), i + 65536);
+        block.clear();
+        for (size_t j = i; j < end; ++j)
+            block.push_back({problem.cities[j].x, problem.cities[j].y, problem.cities[j].tag});
+        out.write(reinterpret_cast<const char *>(block.data()),
+                  static_cast<std::streamsize>(block.size() * sizeof(InstanceCity)));
+    }
+    if (!out) throw std::runtime_error("Error writing " + path + ".");
+}
+
+inline bool isBinaryInstance(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[8] = {};
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, instanceMagic, sizeof(magic)) == 0;
+}
+
+inline Problem readBinaryInstance(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open " + path + ".");
+    InstanceHeader header{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, instanceMagic, sizeof(header.magic)) != 0)
+        throw std::runtime_error("Instance: bad magic in " + path + ".");
+    if (header.version != instanceVersion) throw std::runtime_error("Instance: unsupported version.");
+    if (header.metric > static_cast<uint32_t>(Metric::Ceil2D)) throw std::runtime_error("Instance: unknown metric.");
+    Problem problem;
+    problem.metric = static_cast<Metric>(header.metric);
+    initializeMap(problem.map, header.width, header.height);
+    std::vector<InstanceCity> raw(header.numCities);
+    if (!in.read(reinterpret_cast<char *>(raw.data()), static_cast<std::streamsize>(raw.size() * sizeof(InstanceCity))))
+        throw std::runtime_error("Instance: truncated city list.");
+    problem.cities.resize(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) problem.cities[i] = City{raw[i].x, raw[i].y, raw[i].tag};
+    return problem;
+}
+
+// Lote de tours para pontuacao em massa (saleman_score): TourBatchHeader
+// seguido de count tours de numCities uint32 cada, com os nos numerados de 0
+// na ordem da instancia (numero TSPLIB menos um). Sem padding entre tours,
+// para o arquivo poder ser mapeado e lido direto.
+struct TourBatchHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numCities;
+    uint64_t count;
+    uint64_t reserved;
+};
+static_assert(sizeof(TourBatchHeader) == 32, "TourBatchHeader layout is part of the file format");
+
+inline constexpr char tourBatchMagic[8] = {'S', 'L', 'M', 'N', 'T', 'O', 'U', 'R'};
+inline constexpr uint32_t tourBatchVersion = 1;
+
+inline void writeTourBatch(const std::string &path, const std::vector<std::vector<CityId>> &tours,
+                           const size_t numCities) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot write " + path + ".");
+    TourBatchHeader header{};
+    std::memcpy(header.magic, tourBatchMagic, sizeof(header.magic));
+    header.version = tourBatchVersion;
+    header.numCities = static_cast<uint32_t>(numCities);
+    header.count = tours.size();
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &tour : tours) {
+        if (tour.size() != numCities) throw std::runtime_error("Tour batch: every tour needs numCities entries.");
+        out.write(reinterpret_cast<const char *>(tour.data()), static_cast<std::streamsize>(tour.size() * sizeof(CityId)));
+    }
+    if (!out) throw std::runtime_error("Error writing " + path + ".");
+}
+
+// Binario ou TSPLIB, pelo magic; name so e preenchido no TSPLIB.
+inline Problem readInstance(const std::string &path, std::string *name = nullptr) {
+    return isBinaryInstance(path) ? readBinaryInstance(path) : readTSPLIB(path, name);
+}
+
+#endif //SALEMAN_INSTANCE_IO_H
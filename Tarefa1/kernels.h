@@ -0,0 +1,511 @@
+#ifndef SALEMAN_KERNELS_H
+#define SALEMAN_KERNELS_H
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SALEMAN_X86_KERNELS 1
+#include <immintrin.h>
+#define SALEMAN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SALEMAN_X86_KERNELS 0
+#define SALEMAN_TARGET(isa)
+#endif
+
+// Kernels quentes compilados para varios conjuntos de instrucoes no mesmo
+// binario (o CMakeLists nao passa -march). A escolha e feita uma vez, via
+// cpuid, em kernels(); SALEMAN_ISA=scalar|sse4.2|avx2|avx512 forca um nivel.
+// Os tours sao arrays de uint32_t (CityId em map.h, que inclui este arquivo).
+
+enum class Isa { Scalar, SSE4, AVX2, AVX512 };
+
+inline const char *isaName(const Isa isa) {
+    switch (isa) {
+    case Isa::SSE4: return "sse4.2";
+    case Isa::AVX2: return "avx2";
+    case Isa::AVX512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+inline bool isaSupported(const Isa isa) {
+#if SALEMAN_X86_KERNELS
+    switch (isa) {
+    case Isa::SSE4: return __builtin_cpu_supports("sse4.2");
+    case Isa::AVX2: return __builtin_cpu_supports("avx2");
+    case Isa::AVX512: return __builtin_cpu_supports("avx512f");
+    default: return true;
+    }
+#else
+    return isa == Isa::Scalar;
+#endif
+}
+
+inline Isa bestIsa() {
+    for (const Isa isa : {Isa::AVX512, Isa::AVX2, Isa::SSE4}) {
+        if (isaSupported(isa)) return isa;
+    }
+    return Isa::Scalar;
+}
+
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+    AlignedAllocator() = default;
+    template <typename U>
+    explicit AlignedAllocator(const AlignedAllocator<U> &) noexcept {}
+    T *allocate(const size_t count) {
+        return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{64}));
+    }
+    void deallocate(T *p, size_t) noexcept { ::operator delete(p, std::align_val_t{64}); }
+    bool operator==(const AlignedAllocator &) const noexcept { return true; }
+    bool operator!=(const AlignedAllocator &) const noexcept { return false; }
+};
+
+// A matriz e indexada com int32 nos gathers.
+inline bool batchIndexable(const size_t n) { return n > 0 && n <= 46340; }
+
+// Abaixo disso a matriz cabe na cache e o laco escalar, sem transposicao, vence.
+constexpr size_t BATCH_MIN_CITIES = 640;
+// Acima disso quase toda aresta e uma falta de cache que o gather nao esconde,
+// e a transposicao so acrescenta trabalho: bench_scoring mediu o lote a
+// 0.8-0.95x do laco escalar de 2000 a 10000 cidades.
+constexpr size_t BATCH_MAX_CITIES = 2000;
+
+// Faixa de tamanhos em que a pontuacao em lote mediu mais rapida que a escalar.
+inline bool batchPays(const size_t n) { return n >= BATCH_MIN_CITIES && n < BATCH_MAX_CITIES && batchIndexable(n); }
+
+// ---------------------------------------------------------------------------
+// Escalar. Servem de referencia: toda versao vetorial da o mesmo resultado
+// bit a bit, em qualquer nivel. Por isso routeLength nao tem versao vetorial:
+// somar em lanes paralelas muda a ordem das somas (e o comprimento, no ultimo
+// ulp) conforme a maquina, e o lote deixaria de bater com ele.
+
+// out[j] = distancia euclidiana de (xs[i], ys[i]) a (xs[j], ys[j]), j < n.
+inline void distanceRowScalar(const double *xs, const double *ys, const size_t i, const size_t n,
+                              double *out) {
+    for (size_t j = 0; j < n; ++j) {
+        const double dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+        out[j] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+inline double routeLengthScalar(const uint32_t *order, const size_t n, const double *distM) {
+    double acc = 0.0;
+    for (size_t i = 0; i + 1 < n; ++i) acc += distM[static_cast<size_t>(order[i]) * n + order[i + 1]];
+    return acc + distM[static_cast<size_t>(order[n - 1]) * n + order[0]];
+}
+
+inline void routeLengthBatchScalar(const uint32_t *const *tours, const size_t count, const size_t n,
+                                   const double *distM, double *out) {
+    for (size_t t = 0; t < count; ++t) out[t] = routeLengthScalar(tours[t], n, distM);
+}
+
+// Ganho de cada 2-opt que inverte order[i+1 .. j], para j em [jBegin, jEnd):
+// d(a, c) + d(b, e) - d(a, b) - d(c, e), com a = order[i], b = order[i+1],
+// c = order[j] e e = order[j+1] (circular).
+inline void twoOptDeltasScalar(const uint32_t *order, const size_t n, const double *distM, const size_t i,
+                               const size_t jBegin, const size_t jEnd, double *out) {
+    const size_t a = order[i], b = order[(i + 1) % n];
+    const double dab = distM[a * n + b];
+    for (size_t j = jBegin; j < jEnd; ++j) {
+        const size_t c = order[j], e = order[(j + 1) % n];
+        out[j - jBegin] = distM[a * n + c] + distM[b * n + e] - dab - distM[c * n + e];
+    }
+}
+
+// Copia para out, em ordem, os genes com taken[gene] == 0 e devolve quantos.
+// out precisa de 16 posicoes de folga e taken de 3 bytes de folga no fim.
+inline size_t compactUntakenScalar(const uint32_t *genes, const size_t count, const uint8_t *taken,
+                                   uint32_t *out) {
+    size_t w = 0;
+    for (size_t k = 0; k < count; ++k) {
+        out[w] = genes[k];
+        w += taken[genes[k]] == 0;
+    }
+    return w;
+}
+
+// Versoes inteiras para as metricas TSPLIB (matriz int32): somas em int64,
+// exatas e iguais em todos os niveis.
+inline int64_t routeLengthIntScalar(const uint32_t *order, const size_t n, const int32_t *distM) {
+    int64_t acc = 0;
+    for (size_t i = 0; i + 1 < n; ++i) acc += distM[static_cast<size_t>(order[i]) * n + order[i + 1]];
+    return acc + distM[static_cast<size_t>(order[n - 1]) * n + order[0]];
+}
+
+inline void routeLengthBatchIntScalar(const uint32_t *const *tours, const size_t count, const size_t n,
+                                      const int32_t *distM, int64_t *out) {
+    for (size_t t = 0; t < count; ++t) out[t] = routeLengthIntScalar(tours[t], n, distM);
+}
+
+inline void twoOptDeltasIntScalar(const uint32_t *order, const size_t n, const int32_t *distM, const size_t i,
+                                  const size_t jBegin, const size_t jEnd, int64_t *out) {
+    const size_t a = order[i], b = order[(i + 1) % n];
+    const int64_t dab = distM[a * n + b];
+    for (size_t j = jBegin; j < jEnd; ++j) {
+        const size_t c = order[j], e = order[(j + 1) % n];
+        out[j - jBegin] = int64_t{distM[a * n + c]} + distM[b * n + e] - dab - distM[c * n + e];
+    }
+}
+
+// Transpoe um bloco de W tours para o layout [aresta][lane] ja com o indice
+// linha*n+coluna de cada aresta, para que o laco vetorial leia registradores
+// inteiros com um unico load alinhado.
+template <size_t W>
+inline void edgeIndexBlock(const uint32_t *const *tours, const size_t n, int32_t *block) {
+    for (size_t l = 0; l < W; ++l) {
+        const uint32_t *order = tours[l];
+        for (size_t i = 0; i + 1 < n; ++i) {
+            block[i * W + l] = static_cast<int32_t>(order[i] * n + order[i + 1]);
+        }
+        block[(n - 1) * W + l] = static_cast<int32_t>(order[n - 1] * n + order[0]);
+    }
+}
+
+inline int32_t *edgeIndexScratch(const size_t size) {
+    thread_local std::vector<int32_t, AlignedAllocator<int32_t>> scratch;
+    if (scratch.size() < size) scratch.resize(size);
+    return scratch.data();
+}
+
+#if SALEMAN_X86_KERNELS
+// ---------------------------------------------------------------------------
+// SSE4.2
+
+SALEMAN_TARGET("sse4.2")
+inline void distanceRowSSE4(const double *xs, const double *ys, const size_t i, const size_t n, double *out) {
+    const __m128d xi = _mm_set1_pd(xs[i]), yi = _mm_set1_pd(ys[i]);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        const __m128d dx = _mm_sub_pd(xi, _mm_loadu_pd(xs + j));
+        const __m128d dy = _mm_sub_pd(yi, _mm_loadu_pd(ys + j));
+        _mm_storeu_pd(out + j, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+    }
+    for (; j < n; ++j) {
+        const double dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+        out[j] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+SALEMAN_TARGET("sse4.2")
+inline void routeLengthBatchSSE4(const uint32_t *const *tours, const size_t count, const size_t n,
+                                 const double *distM, double *out) {
+    if (!batchIndexable(n)) return routeLengthBatchScalar(tours, count, n, distM, out);
+    int32_t *block = edgeIndexScratch(4 * n);
+    size_t t = 0;
+    for (; t + 4 <= count; t += 4) {
+        edgeIndexBlock<4>(tours + t, n, block);
+        __m128d acc01 = _mm_setzero_pd(), acc23 = _mm_setzero_pd();
+        for (size_t i = 0; i < n; ++i) {
+            const int32_t *idx = block + i * 4;
+            acc01 = _mm_add_pd(acc01, _mm_setr_pd(distM[idx[0]], distM[idx[1]]));
+            acc23 = _mm_add_pd(acc23, _mm_setr_pd(distM[idx[2]], distM[idx[3]]));
+        }
+        _mm_storeu_pd(out + t, acc01);
+        _mm_storeu_pd(out + t + 2, acc23);
+    }
+    routeLengthBatchScalar(tours + t, count - t, n, distM, out + t);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2
+
+SALEMAN_TARGET("avx2")
+inline void distanceRowAVX2(const double *xs, const double *ys, const size_t i, const size_t n, double *out) {
+    const __m256d xi = _mm256_set1_pd(xs[i]), yi = _mm256_set1_pd(ys[i]);
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        const __m256d dx = _mm256_sub_pd(xi, _mm256_loadu_pd(xs + j));
+        const __m256d dy = _mm256_sub_pd(yi, _mm256_loadu_pd(ys + j));
+        _mm256_storeu_pd(out + j, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+    }
+    for (; j < n; ++j) {
+        const double dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+        out[j] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+SALEMAN_TARGET("avx2")
+inline void routeLengthBatchAVX2(const uint32_t *const *tours, const size_t count, const size_t n,
+                                 const double *distM, double *out) {
+    if (!batchIndexable(n)) return routeLengthBatchScalar(tours, count, n, distM, out);
+    int32_t *block = edgeIndexScratch(8 * n);
+    size_t t = 0;
+    for (; t + 8 <= count; t += 8) {
+        edgeIndexBlock<8>(tours + t, n, block);
+        __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+        for (size_t i = 0; i < n; ++i) {
+            const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i *>(block + i * 8));
+            lo = _mm256_add_pd(lo, _mm256_i32gather_pd(distM, _mm256_castsi256_si128(idx), 8));
+            hi = _mm256_add_pd(hi, _mm256_i32gather_pd(distM, _mm256_extracti128_si256(idx, 1), 8));
+        }
+        _mm256_storeu_pd(out + t, lo);
+        _mm256_storeu_pd(out + t + 4, hi);
+    }
+    routeLengthBatchScalar(tours + t, count - t, n, distM, out + t);
+}
+
+SALEMAN_TARGET("avx2")
+inline void twoOptDeltasAVX2(const uint32_t *order, const size_t n, const double *distM, const size_t i,
+                             const size_t jBegin, const size_t jEnd, double *out) {
+    if (!batchIndexable(n)) return twoOptDeltasScalar(order, n, distM, i, jBegin, jEnd, out);
+    const size_t a = order[i], b = order[(i + 1) % n];
+    const __m256d dab = _mm256_set1_pd(distM[a * n + b]);
+    const double *rowA = distM + a * n, *rowB = distM + b * n;
+    const __m128i vn = _mm_set1_epi32(static_cast<int>(n));
+    size_t j = jBegin;
+    // order[j + 4] precisa existir: a aresta circular fica para o laco escalar
+    for (; j + 4 < n && j + 4 <= jEnd; j += 4) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(order + j));
+        const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i *>(order + j + 1));
+        const __m256d dac = _mm256_i32gather_pd(rowA, c, 8);
+        const __m256d dbe = _mm256_i32gather_pd(rowB, e, 8);
+        const __m256d dce = _mm256_i32gather_pd(distM, _mm_add_epi32(_mm_mullo_epi32(c, vn), e), 8);
+        _mm256_storeu_pd(out + (j - jBegin), _mm256_sub_pd(_mm256_sub_pd(_mm256_add_pd(dac, dbe), dab), dce));
+    }
+    twoOptDeltasScalar(order, n, distM, i, j, jEnd, out + (j - jBegin));
+}
+
+// soma das 8 lanes int32 em duas metades int64
+SALEMAN_TARGET("avx2")
+inline __m256i widenAdd(const __m256i acc, const __m256i v) {
+    return _mm256_add_epi64(_mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v))),
+                            _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+}
+
+SALEMAN_TARGET("avx2")
+inline int64_t routeLengthIntAVX2(const uint32_t *order, const size_t n, const int32_t *distM) {
+    if (!batchIndexable(n)) return routeLengthIntScalar(order, n, distM);
+    const __m256i vn = _mm256_set1_epi32(static_cast<int>(n));
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 9 <= n; i += 8) {
+        const __m256i from = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(order + i));
+        const __m256i to = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(order + i + 1));
+        acc = widenAdd(acc, _mm256_i32gather_epi32(distM, _mm256_add_epi32(_mm256_mullo_epi32(from, vn), to), 4));
+    }
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i + 1 < n; ++i) sum += distM[static_cast<size_t>(order[i]) * n + order[i + 1]];
+    return sum + distM[static_cast<size_t>(order[n - 1]) * n + order[0]];
+}
+
+SALEMAN_TARGET("avx2")
+inline void routeLengthBatchIntAVX2(const uint32_t *const *tours, const size_t count, const size_t n,
+                                    const int32_t *distM, int64_t *out) {
+    if (!batchIndexable(n)) return routeLengthBatchIntScalar(tours, count, n, distM, out);
+    int32_t *block = edgeIndexScratch(8 * n);
+    size_t t = 0;
+    for (; t + 8 <= count; t += 8) {
+        edgeIndexBlock<8>(tours + t, n, block);
+        __m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+        for (size_t i = 0; i < n; ++i) {
+            const __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i *>(block + i * 8));
+            const __m256i d = _mm256_i32gather_epi32(distM, idx, 4);
+            lo = _mm256_add_epi64(lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(d)));
+            hi = _mm256_add_epi64(hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(d, 1)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + t), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + t + 4), hi);
+    }
+    routeLengthBatchIntScalar(tours + t, count - t, n, distM, out + t);
+}
+
+SALEMAN_TARGET("avx2")
+inline void twoOptDeltasIntAVX2(const uint32_t *order, const size_t n, const int32_t *distM, const size_t i,
+                                const size_t jBegin, const size_t jEnd, int64_t *out) {
+    if (!batchIndexable(n)) return twoOptDeltasIntScalar(order, n, distM, i, jBegin, jEnd, out);
+    const size_t a = order[i], b = order[(i + 1) % n];
+    const __m256i dab = _mm256_set1_epi64x(distM[a * n + b]);
+    const int32_t *rowA = distM + a * n, *rowB = distM + b * n;
+    const __m128i vn = _mm_set1_epi32(static_cast<int>(n));
+    size_t j = jBegin;
+    for (; j + 4 < n && j + 4 <= jEnd; j += 4) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(order + j));
+        const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i *>(order + j + 1));
+        const __m256i dac = _mm256_cvtepi32_epi64(_mm_i32gather_epi32(rowA, c, 4));
+        const __m256i dbe = _mm256_cvtepi32_epi64(_mm_i32gather_epi32(rowB, e, 4));
+        const __m256i dce = _mm256_cvtepi32_epi64(
+            _mm_i32gather_epi32(distM, _mm_add_epi32(_mm_mullo_epi32(c, vn), e), 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (j - jBegin)),
+                            _mm256_sub_epi64(_mm256_sub_epi64(_mm256_add_epi64(dac, dbe), dab), dce));
+    }
+    twoOptDeltasIntScalar(order, n, distM, i, j, jEnd, out + (j - jBegin));
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512
+
+SALEMAN_TARGET("avx512f")
+inline void distanceRowAVX512(const double *xs, const double *ys, const size_t i, const size_t n, double *out) {
+    const __m512d xi = _mm512_set1_pd(xs[i]), yi = _mm512_set1_pd(ys[i]);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        const __m512d dx = _mm512_sub_pd(xi, _mm512_loadu_pd(xs + j));
+        const __m512d dy = _mm512_sub_pd(yi, _mm512_loadu_pd(ys + j));
+        _mm512_storeu_pd(out + j, _mm512_sqrt_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy))));
+    }
+    for (; j < n; ++j) {
+        const double dx = xs[i] - xs[j], dy = ys[i] - ys[j];
+        out[j] = std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+SALEMAN_TARGET("avx512f")
+inline void routeLengthBatchAVX512(const uint32_t *const *tours, const size_t count, const size_t n,
+                                   const double *distM, double *out) {
+    if (!batchIndexable(n)) return routeLengthBatchScalar(tours, count, n, distM, out);
+    int32_t *block = edgeIndexScratch(16 * n);
+    size_t t = 0;
+    for (; t + 16 <= count; t += 16) {
+        edgeIndexBlock<16>(tours + t, n, block);
+        __m512d lo = _mm512_setzero_pd(), hi = _mm512_setzero_pd();
+        for (size_t i = 0; i < n; ++i) {
+            const __m512i idx = _mm512_load_si512(block + i * 16);
+            lo = _mm512_add_pd(lo, _mm512_i32gather_pd(_mm512_castsi512_si256(idx), distM, 8));
+            hi = _mm512_add_pd(hi, _mm512_i32gather_pd(_mm512_extracti64x4_epi64(idx, 1), distM, 8));
+        }
+        _mm512_storeu_pd(out + t, lo);
+        _mm512_storeu_pd(out + t + 8, hi);
+    }
+    routeLengthBatchAVX2(tours + t, count - t, n, distM, out + t);
+}
+
+SALEMAN_TARGET("avx512f")
+inline void routeLengthBatchIntAVX512(const uint32_t *const *tours, const size_t count, const size_t n,
+                                      const int32_t *distM, int64_t *out) {
+    if (!batchIndexable(n)) return routeLengthBatchIntScalar(tours, count, n, distM, out);
+    int32_t *block = edgeIndexScratch(16 * n);
+    size_t t = 0;
+    for (; t + 16 <= count; t += 16) {
+        edgeIndexBlock<16>(tours + t, n, block);
+        __m512i lo = _mm512_setzero_si512(), hi = _mm512_setzero_si512();
+        for (size_t i = 0; i < n; ++i) {
+            const __m512i d = _mm512_i32gather_epi32(_mm512_load_si512(block + i * 16), distM, 4);
+            lo = _mm512_add_epi64(lo, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(d)));
+            hi = _mm512_add_epi64(hi, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(d, 1)));
+        }
+        _mm512_storeu_si512(out + t, lo);
+        _mm512_storeu_si512(out + t + 8, hi);
+    }
+    routeLengthBatchIntAVX2(tours + t, count - t, n, distM, out + t);
+}
+
+SALEMAN_TARGET("avx512f")
+inline void twoOptDeltasAVX512(const uint32_t *order, const size_t n, const double *distM, const size_t i,
+                               const size_t jBegin, const size_t jEnd, double *out) {
+    if (!batchIndexable(n)) return twoOptDeltasScalar(order, n, distM, i, jBegin, jEnd, out);
+    const size_t a = order[i], b = order[(i + 1) % n];
+    const __m512d dab = _mm512_set1_pd(distM[a * n + b]);
+    const double *rowA = distM + a * n, *rowB = distM + b * n;
+    const __m256i vn = _mm256_set1_epi32(static_cast<int>(n));
+    size_t j = jBegin;
+    for (; j + 8 < n && j + 8 <= jEnd; j += 8) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(order + j));
+        const __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(order + j + 1));
+        const __m512d dac = _mm512_i32gather_pd(c, rowA, 8);
+        const __m512d dbe = _mm512_i32gather_pd(e, rowB, 8);
+        const __m512d dce = _mm512_i32gather_pd(_mm256_add_epi32(_mm256_mullo_epi32(c, vn), e), distM, 8);
+        _mm512_storeu_pd(out + (j - jBegin), _mm512_sub_pd(_mm512_sub_pd(_mm512_add_pd(dac, dbe), dab), dce));
+    }
+    twoOptDeltasScalar(order, n, distM, i, j, jEnd, out + (j - jBegin));
+}
+
+SALEMAN_TARGET("avx512f,popcnt")
+inline size_t compactUntakenAVX512(const uint32_t *genes, const size_t count, const uint8_t *taken,
+                                   uint32_t *out) {
+    const __m512i low = _mm512_set1_epi32(0xFF);
+    size_t w = 0, k = 0;
+    for (; k + 16 <= count; k += 16) {
+        const __m512i g = _mm512_loadu_si512(genes + k);
+        const __m512i t = _mm512_and_si512(_mm512_i32gather_epi32(g, taken, 1), low);
+        const __mmask16 free = _mm512_cmpeq_epi32_mask(t, _mm512_setzero_si512());
+        _mm512_mask_compressstoreu_epi32(out + w, free, g);
+        w += static_cast<size_t>(_mm_popcnt_u32(free));
+    }
+    return w + compactUntakenScalar(genes + k, count - k, taken, out + w);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Tabela de dispatch
+
+struct KernelTable {
+    Isa isa = Isa::Scalar;
+    void (*distanceRow)(const double *, const double *, size_t, size_t, double *) = distanceRowScalar;
+    double (*routeLength)(const uint32_t *, size_t, const double *) = routeLengthScalar;
+    void (*routeLengthBatch)(const uint32_t *const *, size_t, size_t, const double *, double *) =
+        routeLengthBatchScalar;
+    void (*twoOptDeltas)(const uint32_t *, size_t, const double *, size_t, size_t, size_t, double *) =
+        twoOptDeltasScalar;
+    size_t (*compactUntaken)(const uint32_t *, size_t, const uint8_t *, uint32_t *) = compactUntakenScalar;
+    int64_t (*routeLengthInt)(const uint32_t *, size_t, const int32_t *) = routeLengthIntScalar;
+    void (*routeLengthBatchInt)(const uint32_t *const *, size_t, size_t, const int32_t *, int64_t *) =
+        routeLengthBatchIntScalar;
+    void (*twoOptDeltasInt)(const uint32_t *, size_t, const int32_t *, size_t, size_t, size_t, int64_t *) =
+        twoOptDeltasIntScalar;
+};
+
+// Kernels de um nivel especifico; niveis sem versao propria herdam a do
+// anterior. compactUntaken nao tem versao AVX2: sem compress, a permutacao por
+// tabela mediu mais lenta que o laco escalar sem desvios.
+inline KernelTable kernelTable(const Isa isa) {
+    KernelTable table;
+    table.isa = isa;
+#if SALEMAN_X86_KERNELS
+    if (isa == Isa::SSE4 || isa == Isa::AVX2 || isa == Isa::AVX512) {
+        table.distanceRow = distanceRowSSE4;
+        table.routeLengthBatch = routeLengthBatchSSE4;
+    }
+    if (isa == Isa::AVX2 || isa == Isa::AVX512) {
+        table.distanceRow = distanceRowAVX2;
+        table.routeLengthBatch = routeLengthBatchAVX2;
+        table.twoOptDeltas = twoOptDeltasAVX2;
+        table.routeLengthInt = routeLengthIntAVX2;
+        table.routeLengthBatchInt = routeLengthBatchIntAVX2;
+        table.twoOptDeltasInt = twoOptDeltasIntAVX2;
+    }
+    if (isa == Isa::AVX512) {
+        table.distanceRow = distanceRowAVX512;
+        table.routeLengthBatch = routeLengthBatchAVX512;
+        table.routeLengthBatchInt = routeLengthBatchIntAVX512;
+        table.twoOptDeltas = twoOptDeltasAVX512;
+        table.compactUntaken = compactUntakenAVX512;
+    }
+#endif
+    return table;
+}
+
+// Nivel escolhido: SALEMAN_ISA, se definido e suportado; senao bestIsa().
+inline Isa selectIsa() {
+    if (const char *forced = std::getenv("SALEMAN_ISA")) {
+        for (const Isa isa : {Isa::Scalar, Isa::SSE4, Isa::AVX2, Isa::AVX512}) {
+            if (std::strcmp(forced, isaName(isa)) == 0 && isaSupported(isa)) return isa;
+        }
+    }
+    return bestIsa();
+}
+
+inline const KernelTable &kernels() {
+    static const KernelTable table = kernelTable(selectIsa());
+    return table;
+}
+
+inline void routeLengthBatch(const uint32_t *const *tours, const size_t count, const size_t n,
+                             const double *distM, double *out, const Isa isa) {
+    kernelTable(isa).routeLengthBatch(tours, count, n, distM, out);
+}
+
+inline void routeLengthBatch(const uint32_t *const *tours, const size_t count, const size_t n,
+                             const double *distM, double *out) {
+    kernels().routeLengthBatch(tours, count, n, distM, out);
+}
+
+#endif //SALEMAN_KERNELS_H
@@ -0,0 +1,231 @@
+#ifndef SALEMAN_LOCALSEARCH_H
+#define SALEMAN_LOCALSEARCH_H
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include "candidates.h"
+#include "map.h"
+
+struct LocalSearchParams {
+    bool orOpt = true;
+    size_t maxSegment = 3; // tamanho maximo do segmento movido pelo Or-opt
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+// 2-opt e Or-opt sobre listas de vizinhos (problem.candidates) com
+// "don't look bits": apenas cidades na fila sao examinadas, e cada movimento
+// aplicado recoloca na fila as extremidades das arestas alteradas.
+class LocalSearch {
+public:
+    LocalSearch(Path &path, const Problem &problem, const LocalSearchParams &params)
+        : tour(path.order), problem(problem), params(params), n(path.order.size()), pos(n),
+          queued(n, false) {
+        for (size_t i = 0; i < n; ++i) pos[tour[i]] = static_cast<CityId>(i);
+    }
+
+    void activate(const CityId c) {
+        if (queued[c]) return;
+        queued[c] = true;
+        queue.push_back(c);
+    }
+
+    void activateAll() {
+        for (const CityId c : tour) activate(c);
+    }
+
+    // Retorna o numero de movimentos aplicados.
+    size_t run() {
+        size_t moves = 0;
+        if (n < 5 || problem.candidates.empty()) return moves;
+        size_t checks = 0;
+        while (!queue.empty()) {
+            if ((++checks & 255) == 0 && std::chrono::steady_clock::now() >= params.deadline) break;
+            const CityId a = queue.front();
+            queue.pop_front();
+            queued[a] = false;
+            if (improveTwoOpt(a) || (params.orOpt && improveOrOpt(a))) {
+                ++moves;
+                activate(a);
+            }
+        }
+        return moves;
+    }
+
+private:
+    std::vector<CityId> &tour;
+    const Problem &problem;
+    const LocalSearchParams &params;
+    const size_t n;
+    std::vector<CityId> pos;
+    std::vector<char> queued;
+    std::deque<CityId> queue;
+
+    static constexpr double eps = 1e-9;
+
+    [[nodiscard]] double d(const CityId a, const CityId b) const { return problem.distance(a, b); }
+    [[nodiscard]] CityId succ(const CityId c) const { return tour[(pos[c] + 1) % n]; }
+    [[nodiscard]] CityId pred(const CityId c) const { return tour[(pos[c] + n - 1) % n]; }
+
+    // inverte o trecho do tour que vai, no sentido direto, da posicao i ate j
+    void reverseRange(size_t i, size_t j) {
+        size_t len = ((j + n - i) % n) + 1;
+        for (len /= 2; len > 0; --len) {
+            std::swap(tour[i], tour[j]);
+            pos[tour[i]] = static_cast<CityId>(i);
+            pos[tour[j]] = static_cast<CityId>(j);
+            i = (i + 1) % n;
+            j = (j + n - 1) % n;
+        }
+    }
+
+    // troca as arestas (a, b) e (c, e), com b = succ(a) e e = succ(c), por (a, c) e (b, e)
+    void applyTwoOpt(const CityId a, const CityId b, const CityId c, const CityId e) {
+        const size_t inner = (pos[c] + n - pos[b]) % n + 1;
+        if (2 * inner <= n)
+            reverseRange(pos[b], pos[c]);
+        else
+            reverseRange(pos[e], pos[a]);
+        for (const CityId x : {a, b, c, e}) activate(x);
+    }
+
+    bool improveTwoOpt(const CityId a) {
+        const CandidateGraph &g = problem.candidates;
+        for (int dir = 0; dir < 2; ++dir) {
+            const CityId b = dir == 0 ? succ(a) : pred(a);
+            const double dab = d(a, b);
+            for (uint32_t k = g.offsets[a]; k < g.offsets[a + 1]; ++k) {
+                const CityId c = g.neighbors[k];
+                const double dac = d(a, c);
+                if (dac >= dab) break;
+                const CityId e = dir == 0 ? succ(c) : pred(c);
+                if (c == b || e == a) continue;
+                const double delta = dac + d(b, e) - dab - d(c, e);
+                if (delta < -eps) {
+                    if (dir == 0)
+                        applyTwoOpt(a, b, c, e);
+                    else
+                        applyTwoOpt(e, c, b, a);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool inSegment(const CityId c, const CityId s1, const size_t len) const {
+        return (pos[c] + n - pos[s1]) % n < len;
+    }
+
+    // move o segmento s1..s2 (len cidades) para entre u e v = succ(u)
+    void applyOrOpt(const CityId s1, const CityId s2, const size_t len, const CityId u,
+                    const CityId v, const bool reversed) {
+        const CityId p = pred(s1), nx = succ(s2);
+        const size_t front = (pos[u] + n - pos[nx]) % n + 1; // cidades de nx ate u
+        if (2 * front <= n - len) {
+            reverseRange(pos[s1], pos[u]);
+            reverseRange(pos[u], pos[nx]);
+        } else {
+            reverseRange(pos[v], pos[s2]);
+            reverseRange(pos[p], pos[v]);
+        }
+        if (!reversed) reverseRange(pos[s2], pos[s1]);
+        for (const CityId x : {p, nx, s1, s2, u, v}) activate(x);
+    }
+
+    bool improveOrOpt(const CityId s1) {
+        const CandidateGraph &g = problem.candidates;
+        CityId s2 = s1;
+        for (size_t len = 1; len <= params.maxSegment && len + 3 <= n; ++len) {
+            if (len > 1) s2 = succ(s2);
+            const CityId p = pred(s1), nx = succ(s2);
+            const double removeGain = d(p, s1) + d(s2, nx) - d(p, nx);
+            if (removeGain <= eps) continue;
+
+            for (const CityId end : {s1, s2}) {
+                for (uint32_t k = g.offsets[end]; k < g.offsets[end + 1]; ++k) {
+                    const CityId c = g.neighbors[k];
+                    if (g.dists[k] >= removeGain) break;
+                    if (inSegment(c, s1, len)) continue;
+                    for (int side = 0; side < 2; ++side) {
+                        const CityId u = side == 0 ? c : pred(c);
+                        const CityId v = side == 0 ? succ(c) : c;
+                        if (inSegment(u, s1, len) || inSegment(v, s1, len)) continue;
+                        const double keep = d(u, s1) + d(s2, v);
+                        const double flip = d(u, s2) + d(s1, v);
+                        const double delta = std::min(keep, flip) - d(u, v) - removeGain;
+                        if (delta < -eps) {
+                            applyOrOpt(s1, s2, len, u, v, flip < keep);
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+// 2-opt completo sobre a matriz densa, para problemas sem grafo de
+// candidatos: para cada i, os ganhos de todas as inversoes order[i+1..j] vem
+// de uma chamada ao kernel de deltas e aplica-se o melhor. Com a matriz int32
+// os ganhos sao inteiros e o teste de melhora e exato.
+template <typename Dist, typename Delta, typename Kernel>
+inline size_t twoOptDenseScan(std::vector<CityId> &order, const Dist *distM, const Kernel kernel,
+                              const Delta threshold, const std::chrono::steady_clock::time_point deadline) {
+    const size_t n = order.size();
+    std::vector<Delta> deltas(n);
+    size_t moves = 0;
+    for (bool improved = true; improved;) {
+        improved = false;
+        for (size_t i = 0; i + 2 < n; ++i) {
+            if ((i & 63) == 0 && std::chrono::steady_clock::now() >= deadline) return moves;
+            // com i = 0, j = n - 1 religaria a aresta (order[n-1], order[0]) a ela mesma
+            const size_t jEnd = i == 0 ? n - 1 : n;
+            kernel(order.data(), n, distM, i, i + 2, jEnd, deltas.data());
+            const size_t best = static_cast<size_t>(
+                std::min_element(deltas.begin(), deltas.begin() + (jEnd - i - 2)) - deltas.begin());
+            if (deltas[best] < threshold) {
+                std::reverse(order.begin() + i + 1, order.begin() + i + 3 + best);
+                ++moves;
+                improved = true;
+            }
+        }
+    }
+    return moves;
+}
+
+inline size_t twoOptDense(std::vector<CityId> &order, const Problem &problem,
+                          const std::chrono::steady_clock::time_point deadline) {
+    if (order.size() < 5) return 0;
+    const KernelTable &k = kernels();
+    if (!problem.intDistanceMatrix.empty())
+        return twoOptDenseScan(order, problem.intDistanceMatrix.data(), k.twoOptDeltasInt, int64_t{0}, deadline);
+    if (const double *distM = problem.denseDistances())
+        return twoOptDenseScan(order, distM, k.twoOptDeltas, -1e-9, deadline);
+    return 0;
+}
+
+// Otimiza o tour ate um otimo local. Sem grafo de candidatos, usa twoOptDense. Com `seeds`, so essas cidades comecam
+// ativas (reparo local); senao todas.
+inline size_t localSearch(Path &path, const Problem &problem,
+                          const LocalSearchParams &params = LocalSearchParams(),
+                          const std::vector<CityId> *seeds = nullptr) {
+    if (problem.candidates.empty()) {
+        const size_t moves = twoOptDense(path.order, problem, params.deadline);
+        path.dist = routeLength(path.order, problem);
+        return moves;
+    }
+    LocalSearch ls(path, problem, params);
+    if (seeds) {
+        for (const CityId c : *seeds) ls.activate(c);
+    } else {
+        ls.activateAll();
+    }
+    const size_t moves = ls.run();
+    path.dist = routeLength(path.order, problem);
+    return moves;
+}
+
+#endif //SALEMAN_LOCALSEARCH_H
@@ -0,0 +1,115 @@
+#ifndef SALEMAN_LOD_H
+#define SALEMAN_LOD_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "map.h"
+
+// Nivel de detalhe do visualizador, sem dependencia de raylib: a geometria
+// sai ja em coordenadas de tela e decimada para a resolucao de pixel, entao o
+// custo de desenho depende da area visivel e nao do numero de cidades. P e
+// qualquer ponto agregado {x, y} de float (Vector2 no main).
+
+// Camera2D sem rotacao, tela = (mundo - target) * zoom + offset, mais o
+// retangulo de recorte do painel em coordenadas de tela.
+struct ViewTransform {
+    float targetX = 0.0f, targetY = 0.0f;
+    float offsetX = 0.0f, offsetY = 0.0f;
+    float zoom = 1.0f;
+    float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f;
+
+    [[nodiscard]] float screenX(const float x) const noexcept { return (x - targetX) * zoom + offsetX; }
+    [[nodiscard]] float screenY(const float y) const noexcept { return (y - targetY) * zoom + offsetY; }
+    [[nodiscard]] bool contains(const float sx, const float sy) const noexcept {
+        return sx >= left && sx < right && sy >= top && sy < bottom;
+    }
+};
+
+// Abaixo desse zoom, ou com mais cidades visiveis que lodMaxLabels, as
+// cidades viram pontos, sem marcadores nem rotulos.
+inline constexpr float lodLabelZoom = 1.0f;
+inline constexpr size_t lodMaxLabels = 2000;
+
+[[nodiscard]] inline bool showCityDetail(const float zoom, const size_t visible) noexcept {
+    return zoom >= lodLabelZoom && visible <= lodMaxLabels;
+}
+
+// Regioes de Cohen-Sutherland: bits em comum entre dois pontos significam que
+// o segmento entre eles fica inteiro fora do recorte.
+inline uint8_t outcode(const ViewTransform &view, const float sx, const float sy) noexcept {
+    return static_cast<uint8_t>((sx < view.left) | (sx >= view.right) << 1 | (sy < view.top) << 2 |
+                                (sy >= view.bottom) << 3);
+}
+
+// Tour fechado como polilinha de tela. Pontos consecutivos no mesmo pixel do
+// ultimo ponto emitido sao descartados, e cada trecho que corre inteiro de um
+// mesmo lado fora do recorte vira um unico segmento invisivel.
+template <typename P>
+inline void decimateTour(const std::vector<CityId> &order, const std::vector<City> &cities,
+                         const ViewTransform &view, std::vector<P> &out) {
+    out.clear();
+    const size_t n = order.size();
+    if (n == 0) return;
+
+    auto at = [&](const size_t i) {
+        const City &c = cities[order[i % n]];
+        return P{view.screenX(static_cast<float>(c.x)), view.screenY(static_cast<float>(c.y))};
+    };
+    P last = at(0);
+    out.push_back(last);
+    uint8_t mask = outcode(view, last.x, last.y);
+    P pending{};
+    bool hasPending = false;
+
+    for (size_t i = 1; i <= n; ++i) {
+        const P p = at(i);
+        const uint8_t code = outcode(view, p.x, p.y);
+        if (mask & code) {
+            mask &= code;
+            pending = p;
+            hasPending = true;
+            continue;
+        }
+        if (hasPending) {
+            out.push_back(pending);
+            last = pending;
+            hasPending = false;
+        }
+        mask = code;
+        if (std::floor(p.x) == std::floor(last.x) && std::floor(p.y) == std::floor(last.y)) continue;
+        out.push_back(p);
+        last = p;
+    }
+    if (hasPending) out.push_back(pending);
+    // fecha o ciclo mesmo que o ultimo ponto tenha sido fundido ao anterior
+    if (out.size() > 1 && (out.back().x != out.front().x || out.back().y != out.front().y)) out.push_back(out.front());
+}
+
+// Um ponto por pixel ocupado dentro do recorte (no centro do pixel). Devolve o
+// numero de cidades visiveis, usado para decidir se ha espaco para rotulos.
+template <typename P>
+inline size_t cityPoints(const std::vector<City> &cities, const ViewTransform &view,
+                         std::vector<uint8_t> &occupied, std::vector<P> &out) {
+    const auto width = static_cast<size_t>(std::max(0.0f, view.right - view.left));
+    const auto height = static_cast<size_t>(std::max(0.0f, view.bottom - view.top));
+    occupied.assign(width * height, 0);
+    out.clear();
+    size_t visible = 0;
+    for (const City &c : cities) {
+        const float sx = view.screenX(static_cast<float>(c.x));
+        const float sy = view.screenY(static_cast<float>(c.y));
+        if (!view.contains(sx, sy)) continue;
+        ++visible;
+        const auto px = static_cast<size_t>(sx - view.left);
+        const auto py = static_cast<size_t>(sy - view.top);
+        uint8_t &cell = occupied[py * width + px];
+        if (cell) continue;
+        cell = 1;
+        out.push_back(P{view.left + static_cast<float>(px) + 0.5f, view.top + static_cast<float>(py) + 0.5f});
+    }
+    return visible;
+}
+
+#endif //SALEMAN_LOD_H
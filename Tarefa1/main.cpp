@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <iomanip>
+#include <limits>
 #include <raylib.h>
 #include <sstream>
 #include <vector>
@@ -8,16 +9,43 @@
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
 
 #include "map.h"
 #include "genetic.h"
 #include "annealing.h"
+#include "hilbert.h"
+#include "candidates.h"
+#include "delaunay.h"
+#include "dynamic.h"
+#include "lod.h"
+#include "trajectory.h"
+#include "frame_export.h"
+#include "shared_view.h"
+#include "view_ui.h"
+#include "metrics.h"
+#include "generator.h"
 #include "logger.h"
 
 #define NUM_CITIES 125
+#define CITY_DISTRIBUTION Distribution::Uniform // Clustered, Grid ou Road (generator.h)
 #define NEIGHBORS_PER_TEMP 10
 #define STALL_LIMIT_GA 250
 #define STALL_LIMIT_SA 1000
+#define HILBERT_RENUMBER true
+#define DENSE_MATRIX_LIMIT 10000
+#define QUADRANT_NEIGHBORS 2
+#define SA_CANDIDATE_MOVE_RATE 0.5
+#define DISTANCE_METRIC Metric::Euclidean // Euc2D/Ceil2D: distancias inteiras do TSPLIB em matriz int32
+#define RECORD_TRAJECTORY true // grava as melhoras de cada solver em trajectory_{sa,ga}<n>.bin
+#define TRAJECTORY_KEYFRAME_INTERVAL 64
+#define SHARED_VIEW_INTERVAL_MS 33 // intervalo minimo entre publicacoes de cada solver
+#define METRICS_PORT 0 // porta do /metrics em 127.0.0.1 (0 desativa; "--metrics <porta>" sobrepoe)
+
+
 
 
 class AlgorithmVisualization
@@ -27,14 +55,11 @@ private:
     unsigned int loggerCounter = 0;
 
     Problem problem;
+    double lowerBound = 0.0;
     RNG gaRng;
     RNG saRng;
 
-    std::vector<Path> population;
-    GAParams gaParams;
-    Path gaBestPath;
-    size_t generation = 0;
-    size_t stallCounter = 0;
+    GAState gaState;
     bool gaFinished = false;
 
     AnnealingState saState;
@@ -47,21 +72,77 @@ private:
     std::condition_variable cv;
     std::mutex cvMutex;
     std::atomic<bool> running{ false };
+
+    // Trajetorias da execucao atual; reabertas a cada nova instancia.
+    TrajectoryWriter saTrajectory;
+    TrajectoryWriter gaTrajectory;
+    double saRecorded = std::numeric_limits<double>::infinity();
+    double gaRecorded = std::numeric_limits<double>::infinity();
+    unsigned int trajectoryCounter = 0;
+
+    // Publicacao para o saleman_view (modo --publish). Cada solver publica o
+    // proprio canal na sua thread, sem travas compartilhadas com o leitor.
+    std::unique_ptr<SharedViewWriter> sharedView;
+    std::chrono::steady_clock::time_point saPublished{};
+    std::chrono::steady_clock::time_point gaPublished{};
     bool stepSignal = false;
 
+    // Contadores do /metrics, escritos por cada solver na sua thread e lidos
+    // pelo servidor sem as travas saMutex/gaMutex.
+    SolverMetrics saMetrics;
+    SolverMetrics gaMetrics;
+    std::atomic<uint32_t> metricsCities{ 0 };
+    std::unique_ptr<MetricsServer> metricsServer;
+
     int screenWidth, screenHeight;
     int mapX, mapY, mapW, mapH;
     bool showGA = true;
     bool showSA = true;
 
-    [[nodiscard]] std::vector<City> PathToCity(const std::vector<uint16_t>& order) const {
-        std::vector<City> result;
-        result.reserve(order.size());
-        for (const uint16_t idx : order)
-        {
-            result.push_back(problem.cities[idx]);
-        }
-        return result;
+    // Cache de desenho. As cidades nao se movem: marcadores e rotulos ficam num
+    // RenderTexture refeito so quando a instancia ou a camera mudam. Os tours
+    // viram polilinhas decimadas (lod.h) reconstruidas apenas quando o solver
+    // publica uma nova versao ou a camera se move.
+    static constexpr uint64_t staleVersion = std::numeric_limits<uint64_t>::max();
+    struct TourCache
+    {
+        uint64_t version = staleVersion;
+        uint64_t view = staleVersion;
+        std::vector<Vector2> current;
+        std::vector<Vector2> best;
+    };
+    std::atomic<uint64_t> instanceVersion{ 0 };
+    std::atomic<uint64_t> saVersion{ 0 };
+    std::atomic<uint64_t> gaVersion{ 0 };
+    TourCache saCache;
+    TourCache gaCache;
+    RenderTexture2D cityLayer{};
+    bool cityLayerLoaded = false;
+    uint64_t cityPointsVersion = staleVersion;
+    uint64_t cityPointsView = staleVersion;
+    bool cityDetail = true;
+    std::vector<uint8_t> cityOccupied;
+    std::vector<Vector2> cityPixels;
+
+    // Camera compartilhada pelos dois paineis; offset relativo ao painel.
+    Camera2D camera{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 1.0f };
+    uint64_t viewVersion = 0;
+
+    // Layout da interface como dados (view_ui.h), para que a janela e o
+    // rasterizador sem janela (RenderFrame) desenhem exatamente o mesmo.
+    UiLayout ui;
+
+    int MapBottom() const { return screenHeight - 250; }
+
+    ViewTransform PanelView(const int offsetX) const
+    {
+        return panelView(camera, offsetX, screenWidth / 2, MapBottom());
+    }
+
+    // Polilinha do tour fechado, ja em coordenadas de tela do painel.
+    void TourPoints(const std::vector<CityId>& order, const int offsetX, std::vector<Vector2>& out) const
+    {
+        decimateTour(order, problem.cities, PanelView(offsetX), out);
     }
 
 public:
@@ -78,21 +159,33 @@ public:
         StartThreads();
     }
 
+    // Deve ser destruido antes de CloseWindow: o RenderTexture precisa do contexto GL.
     ~AlgorithmVisualization()
     {
+        metricsServer.reset();
         StopThreads();
+        if (cityLayerLoaded) UnloadRenderTexture(cityLayer);
     }
 
     void InitializeCities(const int numCities)
     {
+        // gera direto na area util, com margem de 20 px, e desloca para a tela
+        GeneratorParams params;
+        params.distribution = CITY_DISTRIBUTION;
+        params.numCities = numCities;
+        params.width = mapW - 40;
+        params.height = mapH - 40;
+        params.seed = gaRng.eng();
+        generateInstance(problem, params);
         initializeMap(problem.map, mapW, mapH);
-        populateCities(problem, gaRng, problem.map, numCities);
 
         for (auto& city : problem.cities)
         {
-            city.x = mapX + 20 + (city.x % (mapW - 40));
-            city.y = mapY + 20 + (city.y % (mapH - 40));
+            city.x += mapX + 20;
+            city.y += mapY + 20;
         }
+
+        if (HILBERT_RENUMBER) renumberCitiesHilbert(problem);
     }
 
     void InitializeAlgorithms()
@@ -101,8 +194,20 @@ public:
         std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
         std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
 
-        problem.distanceMatrix = buildDistanceMatrix(problem);
+        problem.metric = DISTANCE_METRIC;
+        CandidateGraph candidates = buildDelaunayCandidates(problem, QUADRANT_NEIGHBORS);
+        if (problem.numCities() > DENSE_MATRIX_LIMIT)
+        {
+            useSparseDistances(problem, std::move(candidates));
+        }
+        else
+        {
+            problem.candidates = std::move(candidates);
+            buildDenseMatrix(problem);
+        }
+        lowerBound = spanningTreeLowerBound(problem);
 
+        GAParams& gaParams = gaState.params;
         gaParams.populationSize = NUM_CITIES * 10;
         gaParams.generations = NUM_CITIES * 500;
         gaParams.elitism = static_cast<int>(static_cast<double>(gaParams.populationSize) * 0.03f);
@@ -112,32 +217,114 @@ public:
 		gaParams.numMutations = 1;
 		gaParams.stallLimit = STALL_LIMIT_GA;
 
-        population.resize(gaParams.populationSize);
-        initPopulation(population, problem.numCities(), gaRng);
-        evaluate(population, problem.distanceMatrix);
-        std::sort(population.begin(), population.end(),
-            [](const auto& a, const auto& b) { return a.dist < b.dist; });
-
-        gaBestPath = population[0];
-        generation = 0;
-        stallCounter = 0;
+        initGA(gaState, problem, gaRng);
         gaFinished = false;
 
-        saState.problem = problem;
+        saState.problem = &problem;
         saState.params.initialTemp = 1000.0;
         saState.params.finalTemp = 1e-3;
         saState.params.alpha = 1.0 / (0.2 * NUM_CITIES);
         saState.params.actualTemp = saState.params.initialTemp;
         saState.params.neighborsPerTemp = NEIGHBORS_PER_TEMP; 
         saState.params.stallLimit = STALL_LIMIT_SA;
+        saState.params.candidateMoveRate = SA_CANDIDATE_MOVE_RATE;
 
-        saState.currentPath.order.resize(NUM_CITIES);
+        saState.currentPath.order.resize(problem.numCities());
         std::iota(saState.currentPath.order.begin(), saState.currentPath.order.end(), 0);
         std::shuffle(saState.currentPath.order.begin(), saState.currentPath.order.end(), saRng.eng);
-        saState.currentPath.dist = routeLength(saState.currentPath.order, problem.distanceMatrix);
+        saState.currentPath.dist = routeLength(saState.currentPath.order, problem);
         saState.bestPath = saState.currentPath;
         saState.bestDist = saState.currentPath.dist;
         saFinished = false;
+
+        OpenTrajectories();
+        metricsCities = static_cast<uint32_t>(problem.numCities());
+        saMetrics.best.store(saState.bestDist, std::memory_order_relaxed);
+        gaMetrics.best.store(gaState.bestPath.dist, std::memory_order_relaxed);
+        ++instanceVersion;
+        ++saVersion;
+        ++gaVersion;
+    }
+
+    // Chamado com as duas travas dos solvers; o primeiro registro de cada
+    // arquivo e o melhor tour atual.
+    void OpenTrajectories()
+    {
+        if (!RECORD_TRAJECTORY) return;
+        const std::string suffix = std::to_string(trajectoryCounter++) + ".bin";
+        saTrajectory.open("trajectory_sa" + suffix, problem.cities, TRAJECTORY_KEYFRAME_INTERVAL);
+        gaTrajectory.open("trajectory_ga" + suffix, problem.cities, TRAJECTORY_KEYFRAME_INTERVAL);
+        saRecorded = std::numeric_limits<double>::infinity();
+        gaRecorded = std::numeric_limits<double>::infinity();
+        RecordSA();
+        RecordGA();
+    }
+
+    void RecordSA()
+    {
+        if (saState.bestDist >= saRecorded) return;
+        saRecorded = saState.bestDist;
+        saTrajectory.record(saState.bestPath.order, saState.bestDist, saState.currentIterations);
+    }
+
+    void RecordGA()
+    {
+        if (gaState.bestPath.dist >= gaRecorded) return;
+        gaRecorded = gaState.bestPath.dist;
+        gaTrajectory.record(gaState.bestPath.order, gaState.bestPath.dist, gaState.generation);
+    }
+
+    // Insere ou remove uma cidade com os algoritmos em andamento: as
+    // distancias sao atualizadas incrementalmente e os tours reparados.
+    void AddRandomCity()
+    {
+        std::lock(gaMutex, saMutex);
+        std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
+        std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
+
+        City city;
+        city.x = mapX + 20 + static_cast<unsigned int>(gaRng.randint(0, mapW - 41));
+        city.y = mapY + 20 + static_cast<unsigned int>(gaRng.randint(0, mapH - 41));
+        city.tag = 0;
+        for (const auto& c : problem.cities) city.tag = std::max<CityId>(city.tag, c.tag + 1);
+
+        const CityId id = addCity(problem, city);
+        insertCity(gaState, problem, id);
+        insertCity(saState, id);
+        OnInstanceChanged();
+    }
+
+    void RemoveRandomCity()
+    {
+        std::lock(gaMutex, saMutex);
+        std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
+        std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
+
+        if (problem.numCities() <= 4) return;
+        const auto id = static_cast<CityId>(gaRng.randint(0, problem.numCities() - 1));
+        const CityId moved = removeCity(problem, id);
+        eraseCity(gaState, problem, id, moved);
+        eraseCity(saState, id, moved);
+        OnInstanceChanged();
+    }
+
+    void OnInstanceChanged()
+    {
+        Problem bound;
+        bound.cities = problem.cities;
+        bound.metric = problem.metric;
+        bound.candidates = buildDelaunayCandidates(bound);
+        lowerBound = spanningTreeLowerBound(bound);
+        gaFinished = false;
+        saFinished = false;
+
+        OpenTrajectories();
+        metricsCities = static_cast<uint32_t>(problem.numCities());
+        saMetrics.best.store(saState.bestDist, std::memory_order_relaxed);
+        gaMetrics.best.store(gaState.bestPath.dist, std::memory_order_relaxed);
+        ++instanceVersion;
+        ++saVersion;
+        ++gaVersion;
     }
 
     void StartThreads()
@@ -156,6 +343,7 @@ public:
                 {
                     std::lock_guard<std::mutex> lk(saMutex);
                     if (!saFinished) StepSA();
+                    PublishSA(false);
                 }
             }
             });
@@ -171,6 +359,7 @@ public:
                 {
                     std::lock_guard<std::mutex> lk(gaMutex);
                     if (!gaFinished) StepGA();
+                    PublishGA(false);
                 }
             }
             });
@@ -184,6 +373,42 @@ public:
         if (gaThread.joinable()) gaThread.join();
     }
 
+    // Chamados com a trava do respectivo solver.
+    void PublishSA(const bool force)
+    {
+        if (!sharedView) return;
+        const auto now = std::chrono::steady_clock::now();
+        if (!force && now - saPublished < std::chrono::milliseconds(SHARED_VIEW_INTERVAL_MS)) return;
+        saPublished = now;
+        SharedSolverStats stats;
+        stats.step = saState.currentIterations;
+        stats.best = saState.bestDist;
+        stats.current = saState.currentPath.dist;
+        stats.temperature = saState.params.actualTemp;
+        stats.numCities = static_cast<uint32_t>(problem.numCities());
+        stats.finished = saFinished;
+        sharedView->publishSolver(SharedChannel::Annealing, stats, saState.bestPath.order, saState.currentPath.order);
+    }
+
+    void PublishGA(const bool force)
+    {
+        if (!sharedView) return;
+        const auto now = std::chrono::steady_clock::now();
+        if (!force && now - gaPublished < std::chrono::milliseconds(SHARED_VIEW_INTERVAL_MS)) return;
+        gaPublished = now;
+        SharedSolverStats stats;
+        stats.step = gaState.generation;
+        stats.stall = gaState.stallCounter;
+        stats.best = gaState.bestPath.dist;
+        stats.numCities = static_cast<uint32_t>(problem.numCities());
+        stats.finished = gaFinished;
+        static const std::vector<CityId> none;
+        const bool hasCurrent = !gaState.population.empty();
+        stats.current = hasCurrent ? gaState.population[0].dist : gaState.bestPath.dist;
+        sharedView->publishSolver(SharedChannel::Genetic, stats, gaState.bestPath.order,
+            hasCurrent ? gaState.population[0].order : none);
+    }
+
     void StepSA()
     {
         if (saFinished || saState.params.actualTemp <= saState.params.finalTemp)
@@ -192,224 +417,429 @@ public:
             return;
         }
 
-        if (!runAnnealing(saState, saRng))
-        {
-            saFinished = true;
-            return;
-        }
-
+        const unsigned int iterations = saState.iterations;
+        const uint64_t accepted = saState.acceptedMoves;
+        const bool more = runAnnealing(saState, saRng);
+        saMetrics.iterations.fetch_add(saState.iterations - iterations, std::memory_order_relaxed);
+        saMetrics.accepted.fetch_add(saState.acceptedMoves - accepted, std::memory_order_relaxed);
+        saMetrics.stall.store(saState.stallCounter, std::memory_order_relaxed);
+        saMetrics.best.store(saState.bestDist, std::memory_order_relaxed);
+        saMetrics.temperature.store(saState.params.actualTemp, std::memory_order_relaxed);
+        saMetrics.sampleCpu();
+        // o ultimo passo tambem mexeu nos tours: versao, trajetoria e log
+        // sao atualizados antes de encerrar
+        ++saVersion;
+        RecordSA();
         logger.AddSAValue(saState.currentIterations, saState.bestDist);
+        if (!more) saFinished = true;
     }
 
     void StepGA()
     {
-        if (gaFinished || generation >= gaParams.generations || stallCounter >= gaParams.stallLimit)
+        if (gaFinished || gaState.generation >= gaState.params.generations ||
+            gaState.stallCounter >= gaState.params.stallLimit)
         {
             gaFinished = true;
             return;
         }
 
-        std::vector<Path> nextPop(population.size());
-
-        for (size_t e = 0; e < gaParams.elitism; ++e)
-            nextPop[e] = population[e];
+        stepGA(gaState, problem, gaRng);
+        gaMetrics.iterations.fetch_add(1, std::memory_order_relaxed);
+        gaMetrics.stall.store(gaState.stallCounter, std::memory_order_relaxed);
+        gaMetrics.best.store(gaState.bestPath.dist, std::memory_order_relaxed);
+        gaMetrics.sampleCpu();
+        ++gaVersion;
+        RecordGA();
+        logger.AddGAValue(gaState.generation, gaState.bestPath.dist);
+    }
 
-        for (size_t i = gaParams.elitism; i < population.size(); ++i)
+    static void DrawCities(const std::vector<City>& cities, const ViewTransform& view)
+    {
+        for (const auto& c : cities)
         {
-            const Path& p1 = population[tournamentSelect(population, gaRng, gaParams.tournamentK)];
-            const Path& p2 = population[tournamentSelect(population, gaRng, gaParams.tournamentK)];
-            orderCrossover(p1, p2, nextPop[i], gaRng);
-            mutateSwap(nextPop[i], gaParams.mutationRate, gaParams.numMutations,gaRng);
+            if (!view.contains(view.screenX(static_cast<float>(c.x)), view.screenY(static_cast<float>(c.y)))) continue;
+            DrawCircle(c.x, c.y, 8, DARKBLUE);
+            DrawCircle(c.x, c.y, 6, SKYBLUE);
+            std::string s = std::to_string(c.tag);
+            const int tw = MeasureText(s.c_str(), 10);
+            DrawText(s.c_str(), c.x - tw / 2, c.y - 5, 10, WHITE);
         }
+    }
 
-        population.swap(nextPop);
-        evaluate(population, problem.distanceMatrix);
-        std::sort(population.begin(), population.end(),
-            [](const auto& a, const auto& b) { return a.dist < b.dist; });
+    // Pontos e nivel de detalhe das cidades para a camera atual. Com zoom
+    // suficiente e poucas cidades visiveis ha marcadores e rotulos; senao um
+    // ponto por pixel ocupado, limitado pela area do painel. Devolve se mudou.
+    bool RefreshCityPoints()
+    {
+        const uint64_t version = instanceVersion.load();
+        if (cityPointsVersion == version && cityPointsView == viewVersion) return false;
+        const size_t visible = cityPoints(problem.cities, PanelView(0), cityOccupied, cityPixels);
+        cityDetail = showCityDetail(camera.zoom, visible);
+        cityPointsVersion = version;
+        cityPointsView = viewVersion;
+        return true;
+    }
 
-        if (population[0].dist + 1e-9 < gaBestPath.dist)
+    // Redesenha a camada de cidades quando a instancia ou a camera mudam.
+    // Criado sob demanda porque exige a janela ja aberta.
+    void UpdateCityLayer()
+    {
+        const bool changed = RefreshCityPoints();
+        if (cityLayerLoaded && !changed) return;
+        if (!cityLayerLoaded)
         {
-            gaBestPath = population[0];
-            stallCounter = 0;
+            cityLayer = LoadRenderTexture(screenWidth / 2, screenHeight);
+            cityLayerLoaded = true;
+        }
+
+        BeginTextureMode(cityLayer);
+        ClearBackground(BLANK);
+        if (cityDetail)
+        {
+            BeginMode2D(camera);
+            DrawCities(problem.cities, PanelView(0));
+            EndMode2D();
         }
         else
         {
-            stallCounter++;
+            for (const Vector2& p : cityPixels) DrawPixelV(p, SKYBLUE);
         }
+        EndTextureMode();
+    }
 
-        generation++;
-        logger.AddGAValue(generation, gaBestPath.dist);
+    void DrawCityLayer(const int offsetX) const
+    {
+        // texturas de render ficam de cabeca para baixo no OpenGL
+        const Rectangle source{ 0, 0, static_cast<float>(cityLayer.texture.width), -static_cast<float>(cityLayer.texture.height) };
+        DrawTextureRec(cityLayer.texture, source, { static_cast<float>(offsetX), 0 }, WHITE);
     }
 
-    static void DrawPath(const std::vector<City>& path, const Color c, const float thick, const int offsetX = 0)
+    ViewStats Stats() const
     {
-        for (size_t i = 0; i < path.size(); i++)
-        {
-            const City& a = path[i];
-            const City& b = path[(i + 1) % path.size()];
-            DrawLineEx({ static_cast<float>(a.x + offsetX), static_cast<float>(a.y) },
-                { static_cast<float>(b.x + offsetX), static_cast<float>(b.y) }, thick, c);
-        }
+        ViewStats stats;
+        stats.showSA = showSA;
+        stats.showGA = showGA;
+        stats.saTemperature = saState.params.actualTemp;
+        stats.saBest = saState.bestDist;
+        stats.saCurrent = saState.currentPath.dist;
+        stats.saIterations = saState.currentIterations;
+        stats.saFinished = saFinished;
+        stats.gaGeneration = gaState.generation;
+        stats.gaBest = gaState.bestPath.dist;
+        stats.hasGaCurrent = !gaState.population.empty();
+        if (stats.hasGaCurrent) stats.gaCurrent = gaState.population[0].dist;
+        stats.gaStall = gaState.stallCounter;
+        stats.gaFinished = gaFinished;
+        stats.lowerBound = lowerBound;
+        stats.isa = isaName(kernels().isa);
+        stats.help = "Press R to restart, 1 to toggle SA, 2 to toggle GA, A/D to add/remove a city, wheel/drag to zoom/pan, 0 to reset view";
+        return stats;
     }
 
-    static void DrawCities(const std::vector<City>& cities, const int offsetX = 0)
+    void Update()
     {
-        for (const auto& c : cities)
+        if (IsKeyPressed(KEY_R))
         {
-            DrawCircle(c.x + offsetX, c.y, 8, DARKBLUE);
-            DrawCircle(c.x + offsetX, c.y, 6, SKYBLUE);
-            std::string s = std::to_string(c.tag);
-            const int tw = MeasureText(s.c_str(), 10);
-            DrawText(s.c_str(), c.x + offsetX - tw / 2, c.y - 5, 10, WHITE);
+            StopThreads();
+            // InitializeCities(NUM_CITIES);
+            InitializeAlgorithms();
+            loggerCounter++;
+            logger = Logger("tsp_comparison" + std::to_string(loggerCounter) + ".csv");
+            StartThreads();
         }
-    }
-
-    void DrawUI() const {
-        int uiY = screenHeight - 240;
-        int uiHeight = 220;
-        int leftX = 20;
-        int rightX = screenWidth / 2 + 20;
-        int uiWidth = screenWidth / 2 - 40;
 
-        DrawRectangle(leftX, uiY, uiWidth, uiHeight, Fade(BLACK, 0.85f));
-        DrawRectangleLines(leftX, uiY, uiWidth, uiHeight, RAYWHITE);
-        DrawText("Simulated Annealing", leftX + 12, uiY + 8, 20, YELLOW);
+        if (IsKeyPressed(KEY_A))
+        {
+            AddRandomCity();
+        }
 
-        std::ostringstream tss;
-        tss << "Temperature: " << std::scientific << std::setprecision(2) << saState.params.actualTemp;
-        DrawText(tss.str().c_str(), leftX + 12, uiY + 35, 12, YELLOW);
+        if (IsKeyPressed(KEY_D))
+        {
+            RemoveRandomCity();
+        }
 
-        std::ostringstream bss;
-        bss << "Best Distance: " << std::fixed << std::setprecision(1) << saState.bestDist;
-        DrawText(bss.str().c_str(), leftX + 12, uiY + 55, 12, GREEN);
+        if (IsKeyPressed(KEY_ONE))
+        {
+            showSA = !showSA;
+        }
 
-        std::ostringstream css;
-        css << "Current Distance: " << std::fixed << std::setprecision(1) << saState.currentPath.dist;
-        DrawText(css.str().c_str(), leftX + 12, uiY + 75, 12, ORANGE);
+        if (IsKeyPressed(KEY_TWO))
+        {
+            showGA = !showGA;
+        }
 
-        std::ostringstream its;
-        its << "Iterations: " << saState.currentIterations;
-        DrawText(its.str().c_str(), leftX + 12, uiY + 95, 12, LIGHTGRAY);
+        UpdateCamera();
+    }
 
-        if (saFinished)
+    // 0 volta ao enquadramento original.
+    void UpdateCamera()
+    {
+        if (IsKeyPressed(KEY_ZERO))
         {
-            DrawText("FINISHED", leftX + 12, uiY + 115, 14, GREEN);
+            camera = Camera2D{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 1.0f };
+            ++viewVersion;
+            return;
         }
 
-        DrawRectangle(rightX, uiY, uiWidth, uiHeight, Fade(BLACK, 0.85f));
-        DrawRectangleLines(rightX, uiY, uiWidth, uiHeight, RAYWHITE);
-        DrawText("Genetic Algorithm", rightX + 12, uiY + 8, 20, LIME);
+        Vector2 mouse = GetMousePosition();
+        if (mouse.y >= static_cast<float>(MapBottom())) return;
+        const float panelW = static_cast<float>(screenWidth / 2);
+        if (mouse.x >= panelW) mouse.x -= panelW;
+        if (panZoomCamera(camera, mouse)) ++viewVersion;
+    }
+
+    // Refaz as polilinhas dos tours quando o solver publicou uma nova versao
+    // ou a camera mudou; so entao toma a trava do solver.
+    void RefreshTourCaches()
+    {
+        if (showSA && (saCache.version != saVersion.load() || saCache.view != viewVersion))
+        {
+            std::lock_guard<std::mutex> lk(saMutex);
+            saCache.version = saVersion.load();
+            saCache.view = viewVersion;
+            TourPoints(saState.currentPath.order, 0, saCache.current);
+            TourPoints(saState.bestPath.order, 0, saCache.best);
+        }
 
-        std::ostringstream gss;
-        gss << "Generation: " << generation;
-        DrawText(gss.str().c_str(), rightX + 12, uiY + 35, 12, LIME);
+        if (showGA && (gaCache.version != gaVersion.load() || gaCache.view != viewVersion))
+        {
+            const int gaOffsetX = screenWidth / 2;
+            std::lock_guard<std::mutex> lg(gaMutex);
+            gaCache.version = gaVersion.load();
+            gaCache.view = viewVersion;
+            if (gaState.population.empty())
+                gaCache.current.clear();
+            else
+                TourPoints(gaState.population[0].order, gaOffsetX, gaCache.current);
+            TourPoints(gaState.bestPath.order, gaOffsetX, gaCache.best);
+        }
+    }
 
-        std::ostringstream gbss;
-        gbss << "Best Distance: " << std::fixed << std::setprecision(1) << gaBestPath.dist;
-        DrawText(gbss.str().c_str(), rightX + 12, uiY + 55, 12, GREEN);
+    void Draw() {
+        // cidades so mudam pela thread principal (Update), entao nao ha trava aqui
+        UpdateCityLayer();
+        RefreshTourCaches();
+        buildUi(Stats(), screenWidth, screenHeight, mapX, ui);
 
-        std::ostringstream gcss;
-        gcss << "Current Distance: " << std::fixed << std::setprecision(1) << population[0].dist;
-        DrawText(gcss.str().c_str(), rightX + 12, uiY + 75, 12, ORANGE);
+        BeginDrawing();
+        ClearBackground(Color{ 15, 20, 35, 255 });
 
-        std::ostringstream stalls;
-        stalls << "Stall Counter: " << stallCounter;
-        DrawText(stalls.str().c_str(), rightX + 12, uiY + 95, 12, LIGHTGRAY);
+        const int centerX = screenWidth / 2;
+        DrawLine(centerX, 0, centerX, MapBottom(), GRAY);
+        // linhas mais finas quando as cidades viram pontos
+        const float thin = cityDetail ? 2.0f : 1.0f;
+        const float thick = cityDetail ? 3.0f : 2.0f;
 
-        if (gaFinished)
+        if (showSA)
         {
-            DrawText("FINISHED", rightX + 12, uiY + 115, 14, GREEN);
+            BeginScissorMode(0, 0, centerX, MapBottom());
+            drawPath(saCache.current, ORANGE, thin);
+            drawPath(saCache.best, RED, thick);
+            DrawCityLayer(0);
+            EndScissorMode();
         }
 
-        int compY = uiY + 140;
-        DrawText("Comparison:", leftX, compY, 16, WHITE);
-
-        if (saState.bestDist < gaBestPath.dist)
+        if (showGA)
         {
-            DrawText("SA is winning!", leftX, compY + 25, 14, YELLOW);
+            const int gaOffsetX = centerX;
+            BeginScissorMode(gaOffsetX, 0, centerX, MapBottom());
+            drawPath(gaCache.current, LIGHTGRAY, thin);
+            drawPath(gaCache.best, GREEN, thick);
+            DrawCityLayer(gaOffsetX);
+            EndScissorMode();
         }
-        else if (gaBestPath.dist < saState.bestDist)
+
+        drawUi(ui);
+
+        EndDrawing();
+    }
+
+    static Rgba ToRgba(const Color c) { return { c.r, c.g, c.b, c.a }; }
+
+    void RasterCities(Canvas& canvas, const int offsetX) const
+    {
+        if (!cityDetail)
         {
-            DrawText("GA is winning!", leftX, compY + 25, 14, LIME);
+            for (const Vector2& p : cityPixels)
+                blendPixel(canvas, static_cast<int>(p.x) + offsetX, static_cast<int>(p.y), ToRgba(SKYBLUE));
+            return;
         }
-        else
+        const ViewTransform view = PanelView(offsetX);
+        for (const auto& c : problem.cities)
         {
-            DrawText("Tie!", leftX, compY + 25, 14, WHITE);
+            const float sx = view.screenX(static_cast<float>(c.x));
+            const float sy = view.screenY(static_cast<float>(c.y));
+            if (!view.contains(sx, sy)) continue;
+            fillCircle(canvas, sx, sy, 8.0f * view.zoom, ToRgba(DARKBLUE));
+            fillCircle(canvas, sx, sy, 6.0f * view.zoom, ToRgba(SKYBLUE));
+            const std::string s = std::to_string(c.tag);
+            const int size = static_cast<int>(10.0f * view.zoom);
+            drawText(canvas, s, static_cast<int>(sx) - measureText(s, size) / 2, static_cast<int>(sy) - size / 2, size, ToRgba(WHITE));
         }
-
-        std::ostringstream diffs;
-        diffs << "Difference: " << std::fixed << std::setprecision(1)
-            << std::abs(saState.bestDist - gaBestPath.dist);
-        DrawText(diffs.str().c_str(), leftX, compY + 45, 12, GRAY);
     }
 
-    void Update()
+    // Mesmo quadro de Draw, rasterizado em CPU num buffer RGBA; nao usa a janela.
+    void RenderFrame(Canvas& canvas)
     {
-        if (IsKeyPressed(KEY_R))
+        RefreshCityPoints();
+        RefreshTourCaches();
         {
-            StopThreads();
-            // InitializeCities(NUM_CITIES);
-            InitializeAlgorithms();
-            loggerCounter++;
-            logger = Logger("tsp_comparison" + std::to_string(loggerCounter) + ".csv");
-            StartThreads();
+            std::lock(gaMutex, saMutex);
+            std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
+            std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
+            buildUi(Stats(), screenWidth, screenHeight, mapX, ui);
         }
 
-        if (IsKeyPressed(KEY_ONE))
+        // o quadro anterior foi movido para o codificador: o buffer volta vazio
+        if (canvas.pixels.size() != static_cast<size_t>(screenWidth) * screenHeight * 4)
+            resizeCanvas(canvas, screenWidth, screenHeight);
+        clearCanvas(canvas, { 15, 20, 35, 255 });
+
+        const int centerX = screenWidth / 2;
+        fillRect(canvas, centerX, 0, 1, MapBottom(), ToRgba(GRAY));
+        const float thin = cityDetail ? 2.0f : 1.0f;
+        const float thick = cityDetail ? 3.0f : 2.0f;
+
+        if (showSA)
         {
-            showSA = !showSA;
+            drawPolyline(canvas, saCache.current, thin, ToRgba(ORANGE));
+            drawPolyline(canvas, saCache.best, thick, ToRgba(RED));
+            RasterCities(canvas, 0);
         }
 
-        if (IsKeyPressed(KEY_TWO))
+        if (showGA)
         {
-            showGA = !showGA;
+            drawPolyline(canvas, gaCache.current, thin, ToRgba(LIGHTGRAY));
+            drawPolyline(canvas, gaCache.best, thick, ToRgba(GREEN));
+            RasterCities(canvas, centerX);
         }
 
+        for (const UiBox& b : ui.boxes)
+        {
+            fillRect(canvas, b.x, b.y, b.w, b.h, ToRgba(b.fill));
+            strokeRect(canvas, b.x, b.y, b.w, b.h, ToRgba(b.border));
+        }
+        for (const UiText& t : ui.texts) drawText(canvas, t.text, t.x, t.y, t.size, ToRgba(t.color));
     }
 
-    void Draw() const {
-        BeginDrawing();
-        ClearBackground(Color{ 15, 20, 35, 255 });
-
-        const int centerX = screenWidth / 2;
-        DrawLine(centerX, 0, centerX, screenHeight - 250, GRAY);
-
-        if (showSA)
+    // Execucao sem janela para nos de computacao: os solvers andam como no modo
+    // interativo e um quadro e exportado como PNG a cada 1/framesPerSecond s.
+    // seconds <= 0 roda ate os dois algoritmos terminarem.
+    void RunHeadless(const std::string& directory, const double framesPerSecond, const double seconds)
+    {
+        FrameRecorder recorder(directory, framesPerSecond);
+        Canvas frame;
+        const auto start = std::chrono::steady_clock::now();
+        auto finished = [this]() {
+            std::lock(gaMutex, saMutex);
+            std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
+            std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
+            return saFinished && gaFinished;
+        };
+
+        while (true)
         {
-            DrawText("Simulated Annealing", mapX, 20, 20, YELLOW);
-            std::vector<City> saCurrentPathCities;
-            std::vector<City> saBestPathCities;
             {
-                std::lock_guard<std::mutex> lk(saMutex);
-                saCurrentPathCities = PathToCity(saState.currentPath.order);
-                saBestPathCities = PathToCity(saState.bestPath.order);
+                std::lock_guard<std::mutex> lk(cvMutex);
+                stepSignal = true;
+            }
+            cv.notify_all();
+
+            const bool done = finished() ||
+                (seconds > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= seconds);
+            if (done || recorder.due())
+            {
+                RenderFrame(frame);
+                recorder.submit(std::move(frame));
             }
-            DrawPath(saCurrentPathCities, ORANGE, 2.0f);
-            DrawPath(saBestPathCities, RED, 3.0f);
-            DrawCities(saBestPathCities);
+            if (done) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
+        StopThreads();
+        recorder.close();
+        TraceLog(LOG_INFO, "SALEMAN: headless run wrote %zu frames to %s (%zu dropped)", recorder.written(),
+            directory.c_str(), recorder.droppedFrames());
+        if (recorder.failedWrites() > 0)
+            TraceLog(LOG_ERROR, "SALEMAN: %zu frames could not be written to %s", recorder.failedWrites(),
+                directory.c_str());
+    }
 
-        if (showGA)
+    // Solver sem janela publicando em memoria compartilhada para o
+    // saleman_view, que pode entrar e sair durante a execucao. seconds <= 0
+    // roda ate os dois algoritmos terminarem.
+    void RunPublisher(const std::string& name, const double seconds)
+    {
         {
-            const int gaOffsetX = centerX;
-            DrawText("Genetic Algorithm", mapX + gaOffsetX, 20, 20, LIME);
-            std::vector<City> gaCurrentPathCities;
-            std::vector<City> gaBestPathCities;
+            std::lock(gaMutex, saMutex);
+            std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
+            std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
+            sharedView = std::make_unique<SharedViewWriter>(name, static_cast<uint32_t>(problem.numCities()));
+            sharedView->publishInstance(problem.cities, lowerBound);
+        }
+        TraceLog(LOG_INFO, "SALEMAN: publishing solver state on %s", name.c_str());
+
+        const auto start = std::chrono::steady_clock::now();
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lk(cvMutex);
+                stepSignal = true;
+            }
+            cv.notify_all();
+            sharedView->heartbeat();
+
+            bool done;
             {
-                std::lock_guard<std::mutex> lg(gaMutex);
-                if (!population.empty()) gaCurrentPathCities = PathToCity(population[0].order);
-                gaBestPathCities = PathToCity(gaBestPath.order);
+                std::lock(gaMutex, saMutex);
+                std::lock_guard<std::mutex> lg1(gaMutex, std::adopt_lock);
+                std::lock_guard<std::mutex> lg2(saMutex, std::adopt_lock);
+                done = saFinished && gaFinished;
             }
-            DrawPath(gaCurrentPathCities, LIGHTGRAY, 2.0f, gaOffsetX);
-            DrawPath(gaBestPathCities, GREEN, 3.0f, gaOffsetX);
-            DrawCities(gaBestPathCities, gaOffsetX);
+            done = done || (seconds > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= seconds);
+            if (done) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
+        StopThreads();
+        // threads paradas: o estado final pode ser publicado daqui
+        PublishSA(true);
+        PublishGA(true);
+        sharedView.reset();
+    }
 
-        DrawUI();
-
-        DrawText("Press R to restart, 1 to toggle SA, 2 to toggle GA", 20, screenHeight - 20, 12, WHITE);
+    // Sobe o endpoint /metrics; chamado uma vez, antes do laco principal.
+    void ServeMetrics(const uint16_t port)
+    {
+        metricsServer = std::make_unique<MetricsServer>(port, [this]() { return RenderMetrics(); });
+        TraceLog(LOG_INFO, "SALEMAN: metrics on http://127.0.0.1:%u/metrics", metricsServer->port());
+    }
 
-        EndDrawing();
+    // Roda na thread do servidor: apenas leituras atomicas.
+    std::string RenderMetrics() const
+    {
+        constexpr auto relaxed = std::memory_order_relaxed;
+        MetricsText m;
+        m.family("saleman_sa_iterations_total", "counter", "Neighbours evaluated by simulated annealing.")
+            .sample("saleman_sa_iterations_total", static_cast<double>(saMetrics.iterations.load(relaxed)));
+        m.family("saleman_sa_accepted_moves_total", "counter", "Moves accepted by simulated annealing.")
+            .sample("saleman_sa_accepted_moves_total", static_cast<double>(saMetrics.accepted.load(relaxed)));
+        m.family("saleman_sa_temperature", "gauge", "Current annealing temperature.")
+            .sample("saleman_sa_temperature", saMetrics.temperature.load(relaxed));
+        m.family("saleman_ga_generations_total", "counter", "Generations run by the genetic algorithm.")
+            .sample("saleman_ga_generations_total", static_cast<double>(gaMetrics.iterations.load(relaxed)));
+        m.family("saleman_best_distance", "gauge", "Length of the best tour found.")
+            .sample("saleman_best_distance", saMetrics.best.load(relaxed), "solver=\"sa\"")
+            .sample("saleman_best_distance", gaMetrics.best.load(relaxed), "solver=\"ga\"");
+        m.family("saleman_stall_counter", "gauge", "Steps since the best tour last improved.")
+            .sample("saleman_stall_counter", static_cast<double>(saMetrics.stall.load(relaxed)), "solver=\"sa\"")
+            .sample("saleman_stall_counter", static_cast<double>(gaMetrics.stall.load(relaxed)), "solver=\"ga\"");
+        m.family("saleman_thread_cpu_seconds_total", "counter", "CPU time used by each solver thread.")
+            .sample("saleman_thread_cpu_seconds_total", saMetrics.cpuSeconds.load(relaxed), "solver=\"sa\"")
+            .sample("saleman_thread_cpu_seconds_total", gaMetrics.cpuSeconds.load(relaxed), "solver=\"ga\"");
+        m.family("saleman_cities", "gauge", "Cities in the current instance.")
+            .sample("saleman_cities", metricsCities.load(relaxed));
+        m.family("process_resident_memory_bytes", "gauge", "Resident memory size in bytes.")
+            .sample("process_resident_memory_bytes", static_cast<double>(residentMemoryBytes()));
+        return m.str();
     }
 
     void Run()
@@ -428,15 +858,228 @@ public:
     }
 };
 
-int main()
+// Reproducao de uma trajetoria gravada, sem solver: a posicao e um instante
+// da execucao original, que avanca na velocidade escolhida ou e arrastado
+// pela linha do tempo.
+class TrajectoryReplay
+{
+private:
+    TrajectoryReader reader;
+    std::string path;
+    int screenWidth, screenHeight;
+
+    double position = 0.0; // segundos desde o inicio da gravacao
+    double speed = 1.0;
+    bool playing = true;
+    size_t shown = std::numeric_limits<size_t>::max();
+    uint64_t drawnView = std::numeric_limits<uint64_t>::max();
+    std::vector<CityId> order;
+    std::vector<Vector2> points;
+    std::vector<uint8_t> occupied;
+    std::vector<Vector2> pixels;
+
+    Camera2D camera{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 1.0f };
+    uint64_t viewVersion = 0;
+
+    int MapBottom() const { return screenHeight - 120; }
+    Rectangle Timeline() const
+    {
+        return { 20.0f, static_cast<float>(screenHeight - 40), static_cast<float>(screenWidth - 40), 12.0f };
+    }
+    double Duration() const { return static_cast<double>(reader.frame(reader.size() - 1).micros) * 1e-6; }
+    size_t Current() const { return reader.indexAt(static_cast<uint64_t>(position * 1e6)); }
+
+    ViewTransform View() const
+    {
+        ViewTransform view;
+        view.targetX = camera.target.x;
+        view.targetY = camera.target.y;
+        view.offsetX = camera.offset.x;
+        view.offsetY = camera.offset.y;
+        view.zoom = camera.zoom;
+        view.right = static_cast<float>(screenWidth);
+        view.bottom = static_cast<float>(MapBottom());
+        return view;
+    }
+
+    // Posiciona exatamente sobre o registro i.
+    void Seek(const size_t i) { position = static_cast<double>(reader.frame(i).micros) * 1e-6; }
+
+public:
+    TrajectoryReplay(const std::string& file, const int width, const int height)
+        : reader(file), path(file), screenWidth(width), screenHeight(height) {}
+
+    void Update()
+    {
+        const size_t current = Current();
+        if (IsKeyPressed(KEY_SPACE)) playing = !playing;
+        if (IsKeyPressed(KEY_UP)) speed *= 2.0;
+        if (IsKeyPressed(KEY_DOWN)) speed *= 0.5;
+        if (IsKeyPressed(KEY_HOME)) Seek(0);
+        if (IsKeyPressed(KEY_END)) Seek(reader.size() - 1);
+        if (IsKeyPressed(KEY_RIGHT) && current + 1 < reader.size()) Seek(current + 1);
+        if (IsKeyPressed(KEY_LEFT) && current > 0) Seek(current - 1);
+        if (IsKeyPressed(KEY_ZERO))
+        {
+            camera = Camera2D{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 1.0f };
+            ++viewVersion;
+        }
+
+        const Vector2 mouse = GetMousePosition();
+        const Rectangle bar = Timeline();
+        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && mouse.y >= bar.y - 8.0f && mouse.y <= bar.y + bar.height + 8.0f)
+        {
+            const float t = std::clamp((mouse.x - bar.x) / bar.width, 0.0f, 1.0f);
+            position = t * Duration();
+        }
+        else if (mouse.y < static_cast<float>(MapBottom()) && panZoomCamera(camera, mouse))
+        {
+            ++viewVersion;
+        }
+
+        if (playing) position = std::min(position + GetFrameTime() * speed, Duration());
+    }
+
+    void Draw()
+    {
+        const size_t current = Current();
+        if (current != shown || drawnView != viewVersion)
+        {
+            if (current != shown) reader.tourAt(current, order);
+            decimateTour(order, reader.cities(), View(), points);
+            cityPoints(reader.cities(), View(), occupied, pixels);
+            shown = current;
+            drawnView = viewVersion;
+        }
+        const TrajectoryReader::Frame& frame = reader.frame(current);
+
+        BeginDrawing();
+        ClearBackground(Color{ 15, 20, 35, 255 });
+
+        BeginScissorMode(0, 0, screenWidth, MapBottom());
+        if (points.size() >= 2) DrawSplineLinear(points.data(), static_cast<int>(points.size()), 2.0f, GREEN);
+        for (const Vector2& p : pixels) DrawPixelV(p, SKYBLUE);
+        EndScissorMode();
+
+        const Rectangle bar = Timeline();
+        DrawRectangleRec(bar, Fade(GRAY, 0.5f));
+        const double duration = Duration();
+        const float done = duration > 0.0 ? static_cast<float>(position / duration) : 1.0f;
+        DrawRectangleRec({ bar.x, bar.y, bar.width * done, bar.height }, LIME);
+
+        std::ostringstream hud;
+        hud << "Replay: " << path << "   record " << current + 1 << "/" << reader.size() << "   step "
+            << frame.step << "   distance " << std::fixed << std::setprecision(1) << frame.dist << "   t "
+            << std::setprecision(2) << position << "s / " << duration << "s   speed x" << speed
+            << (playing ? "" : "   PAUSED");
+        DrawText(hud.str().c_str(), 20, screenHeight - 80, 14, WHITE);
+        DrawText("Space play/pause, Up/Down speed, Left/Right previous/next improvement, Home/End, drag the bar to scrub, wheel/drag to zoom/pan, 0 to reset view",
+            20, screenHeight - 60, 12, GRAY);
+
+        EndDrawing();
+    }
+
+    void Run()
+    {
+        while (!WindowShouldClose())
+        {
+            Update();
+            Draw();
+        }
+    }
+};
+
+// saleman                                      compara SA e GA ao vivo
+// saleman --replay <arquivo>                   reproduz uma trajetoria gravada
+// saleman --headless <dir> [fps] [segundos]    sem janela, quadros PNG em dir
+// saleman --publish [nome] [segundos]          sem janela, estado em memoria compartilhada
+// saleman --metrics <porta> [modo ...]         qualquer modo acima com /metrics em 127.0.0.1
+int main(int argc, char** argv)
 {
     constexpr int screenWidth = 1680;
     constexpr int screenHeight = 720;
 
-    InitWindow(screenWidth, screenHeight, "TSP: Simulated Annealing vs Genetic Algorithm");
+    unsigned long metricsPort = METRICS_PORT;
+    if (argc >= 3 && std::strcmp(argv[1], "--metrics") == 0)
+    {
+        char* end = nullptr;
+        metricsPort = std::strtoul(argv[2], &end, 10);
+        if (*end != '\0' || metricsPort == 0 || metricsPort > 65535)
+        {
+            TraceLog(LOG_ERROR, "SALEMAN: invalid metrics port %s", argv[2]);
+            return 1;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc >= 3 && std::strcmp(argv[1], "--headless") == 0)
+    {
+        try
+        {
+            const double fps = argc >= 4 ? std::stod(argv[3]) : 2.0;
+            const double seconds = argc >= 5 ? std::stod(argv[4]) : 0.0;
+            TraceLog(LOG_INFO, "SALEMAN: distance/tour kernels using %s", isaName(kernels().isa));
+            AlgorithmVisualization app(screenWidth, screenHeight);
+            if (metricsPort) app.ServeMetrics(static_cast<uint16_t>(metricsPort));
+            app.RunHeadless(argv[2], fps, seconds);
+        }
+        catch (const std::exception& e)
+        {
+            TraceLog(LOG_ERROR, "SALEMAN: %s", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "--publish") == 0)
+    {
+        try
+        {
+            const std::string name = argc >= 3 ? argv[2] : sharedViewName;
+            const double seconds = argc >= 4 ? std::stod(argv[3]) : 0.0;
+            TraceLog(LOG_INFO, "SALEMAN: distance/tour kernels using %s", isaName(kernels().isa));
+            AlgorithmVisualization app(screenWidth, screenHeight);
+            if (metricsPort) app.ServeMetrics(static_cast<uint16_t>(metricsPort));
+            app.RunPublisher(name, seconds);
+        }
+        catch (const std::exception& e)
+        {
+            TraceLog(LOG_ERROR, "SALEMAN: %s", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    const bool replay = argc == 3 && std::strcmp(argv[1], "--replay") == 0;
+    InitWindow(screenWidth, screenHeight, replay ? "TSP: trajectory replay" : "TSP: Simulated Annealing vs Genetic Algorithm");
+    TraceLog(LOG_INFO, "SALEMAN: distance/tour kernels using %s", isaName(kernels().isa));
 
-    AlgorithmVisualization app(screenWidth, screenHeight);
-    app.Run();
+    if (replay)
+    {
+        try
+        {
+            TrajectoryReplay app(argv[2], screenWidth, screenHeight);
+            app.Run();
+        }
+        catch (const std::exception& e)
+        {
+            TraceLog(LOG_ERROR, "SALEMAN: %s", e.what());
+        }
+    }
+    else
+    {
+        AlgorithmVisualization app(screenWidth, screenHeight);
+        try
+        {
+            if (metricsPort) app.ServeMetrics(static_cast<uint16_t>(metricsPort));
+        }
+        catch (const std::exception& e)
+        {
+            TraceLog(LOG_ERROR, "SALEMAN: %s", e.what());
+        }
+        app.Run();
+    }
 
     CloseWindow();
     return 0;
@@ -4,6 +4,12 @@
 #include <vector>
 #include <cmath>
 #include <random>
+#include <type_traits>
+
+#include "kernels.h"
+
+using CityId = uint32_t;
+static_assert(std::is_same_v<CityId, uint32_t>, "kernels.h assumes 32-bit city ids");
 
 struct Map {
     unsigned int width{0}, height{0};
@@ -11,7 +17,43 @@ struct Map {
 
 struct City {
     unsigned int x{0}, y{0};
-    uint16_t tag{0};
+    CityId tag{0};
+};
+
+static double euclid(const unsigned int ax, const unsigned int ay, const unsigned int bx,
+                     const unsigned int by) noexcept {
+    // mesma sequencia de operacoes de distanceRow, para a matriz e o calculo
+    // sob demanda concordarem bit a bit
+    const double dx = static_cast<double>(ax) - static_cast<double>(bx);
+    const double dy = static_cast<double>(ay) - static_cast<double>(by);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Euclidean usa a distancia real em double. Euc2D e Ceil2D seguem as
+// convencoes EUC_2D (nint) e CEIL_2D do TSPLIB: distancias inteiras, guardadas
+// em matriz int32, e comprimentos exatos comparaveis com os otimos publicados.
+enum class Metric { Euclidean, Euc2D, Ceil2D };
+
+inline bool integralMetric(const Metric metric) noexcept { return metric != Metric::Euclidean; }
+
+inline double applyMetric(const Metric metric, const double d) noexcept {
+    switch (metric) {
+    case Metric::Euc2D: return static_cast<double>(static_cast<int32_t>(d + 0.5));
+    case Metric::Ceil2D: return std::ceil(d);
+    default: return d;
+    }
+}
+
+// Grafo de candidatos em formato CSR: os vizinhos da cidade i ficam em
+// neighbors[offsets[i] .. offsets[i + 1]), com a distancia correspondente em dists.
+struct CandidateGraph {
+    std::vector<uint32_t> offsets;
+    std::vector<CityId> neighbors;
+    std::vector<float> dists;
+    [[nodiscard]] bool empty() const noexcept { return offsets.empty(); }
+    [[nodiscard]] size_t degree(const size_t i) const noexcept {
+        return offsets[i + 1] - offsets[i];
+    }
 };
 
 struct Problem {
@@ -19,10 +61,40 @@ struct Problem {
     Map map;
     [[nodiscard]] size_t numCities() const noexcept { return cities.size(); }
     std::vector<double> distanceMatrix;
+    std::vector<int32_t> intDistanceMatrix; // substitui distanceMatrix nas metricas inteiras
+    const double *externalMatrix = nullptr; // matriz n x n de quem chama, usada sem copia
+    CandidateGraph candidates;
+    Metric metric = Metric::Euclidean;
+
+    // Distancia entre duas cidades calculada a partir das coordenadas.
+    [[nodiscard]] double cityDistance(const size_t a, const size_t b) const noexcept {
+        return applyMetric(metric, euclid(cities[a].x, cities[a].y, cities[b].x, cities[b].y));
+    }
+
+    // Matriz densa em double, propria ou emprestada; nullptr se nao houver.
+    [[nodiscard]] const double *denseDistances() const noexcept {
+        if (externalMatrix) return externalMatrix;
+        return distanceMatrix.empty() ? nullptr : distanceMatrix.data();
+    }
+
+    // Matriz densa quando existir; senao procura no grafo de candidatos e, para
+    // pares fora dele, calcula a distancia sob demanda.
+    [[nodiscard]] double distance(const size_t a, const size_t b) const noexcept {
+        if (!intDistanceMatrix.empty()) return intDistanceMatrix[a * numCities() + b];
+        if (const double *m = denseDistances()) return m[a * numCities() + b];
+        if (!candidates.empty()) {
+            for (uint32_t k = candidates.offsets[a]; k < candidates.offsets[a + 1]; ++k) {
+                if (candidates.neighbors[k] == b) return candidates.dists[k];
+            }
+            // mesma precisao do grafo, para que d(a, b) == d(b, a)
+            return static_cast<float>(cityDistance(a, b));
+        }
+        return cityDistance(a, b);
+    }
 };
 
 struct Path {
-    std::vector<uint16_t> order;
+    std::vector<CityId> order;
     double dist = std::numeric_limits<double>::infinity();
 };
 
@@ -44,35 +116,110 @@ struct RNG {
     double rand01() { return real01(eng); }
 };
 
-static double euclid(const unsigned int ax, const unsigned int ay, const unsigned int bx,
-                     const unsigned int by) noexcept {
-    return std::hypot(static_cast<double>(ax) - static_cast<double>(bx),
-                      static_cast<double>(ay) - static_cast<double>(by));
+// Coordenadas em SoA para distanceRow.
+inline void cityCoordinates(const Problem &p, std::vector<double> &xs, std::vector<double> &ys) {
+    const size_t n = p.numCities();
+    xs.resize(n);
+    ys.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        xs[i] = p.cities[i].x;
+        ys[i] = p.cities[i].y;
+    }
 }
 
+// Matriz densa em double na metrica do problema.
 inline std::vector<double> buildDistanceMatrix(const Problem &p) {
     const size_t n = p.numCities();
-    std::vector<double> m(n * n, 0.0);
+    std::vector<double> xs, ys;
+    cityCoordinates(p, xs, ys);
+    // linhas completas: d(i, j) e d(j, i) saem das mesmas operacoes, entao a
+    // matriz fica simetrica sem escritas em coluna
+    std::vector<double> m(n * n);
+    const KernelTable &k = kernels();
     for (size_t i = 0; i < n; ++i) {
-        m[i * n + i] = 0.0;
-        for (size_t j = i + 1; j < n; ++j) {
-            const double d =
-                euclid(p.cities[i].x, p.cities[i].y, p.cities[j].x, p.cities[j].y);
-            m[i * n + j] = d;
-            m[j * n + i] = d;
+        double *row = &m[i * n];
+        k.distanceRow(xs.data(), ys.data(), i, n, row);
+        if (integralMetric(p.metric)) {
+            for (size_t j = 0; j < n; ++j) row[j] = applyMetric(p.metric, row[j]);
         }
     }
     return m;
 }
 
-static double routeLength(const std::vector<uint16_t> &order,
+// Matriz int32 para as metricas inteiras: metade da memoria da versao double.
+inline std::vector<int32_t> buildIntDistanceMatrix(const Problem &p) {
+    const size_t n = p.numCities();
+    std::vector<double> xs, ys, row(n);
+    cityCoordinates(p, xs, ys);
+    std::vector<int32_t> m(n * n);
+    const KernelTable &k = kernels();
+    for (size_t i = 0; i < n; ++i) {
+        k.distanceRow(xs.data(), ys.data(), i, n, row.data());
+        for (size_t j = 0; j < n; ++j) m[i * n + j] = static_cast<int32_t>(applyMetric(p.metric, row[j]));
+    }
+    return m;
+}
+
+// Monta a matriz densa adequada a metrica do problema (int32 nas inteiras).
+inline void buildDenseMatrix(Problem &p) {
+    p.externalMatrix = nullptr;
+    if (integralMetric(p.metric)) {
+        p.distanceMatrix.clear();
+        p.intDistanceMatrix = buildIntDistanceMatrix(p);
+    } else {
+        p.intDistanceMatrix.clear();
+        p.distanceMatrix = buildDistanceMatrix(p);
+    }
+}
+
+[[nodiscard]] inline bool hasDenseMatrix(const Problem &p) noexcept {
+    return !p.distanceMatrix.empty() || !p.intDistanceMatrix.empty() || p.externalMatrix;
+}
+
+// Troca a metrica do problema. Nas metricas inteiras a matriz densa, se
+// existir, passa a ser int32; as distancias do grafo de candidatos sao
+// recalculadas a partir das coordenadas.
+inline void setMetric(Problem &p, const Metric metric) {
+    const bool dense = hasDenseMatrix(p);
+    p.metric = metric;
+    p.distanceMatrix = {};
+    p.intDistanceMatrix = {};
+    p.externalMatrix = nullptr;
+    if (dense) buildDenseMatrix(p);
+    CandidateGraph &g = p.candidates;
+    for (size_t i = 0; i + 1 < g.offsets.size(); ++i) {
+        for (uint32_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e) {
+            g.dists[e] = static_cast<float>(p.cityDistance(i, g.neighbors[e]));
+        }
+    }
+}
+
+static double routeLength(const std::vector<CityId> &order,
                           const std::vector<double> &distM) noexcept {
+    return kernels().routeLength(order.data(), order.size(), distM.data());
+}
+
+// Comprimento inteiro e exato do tour; so faz sentido nas metricas inteiras.
+inline int64_t tourLength(const std::vector<CityId> &order, const Problem &problem) noexcept {
+    const size_t n = order.size();
+    if (!problem.intDistanceMatrix.empty())
+        return kernels().routeLengthInt(order.data(), n, problem.intDistanceMatrix.data());
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc += static_cast<int64_t>(problem.distance(order[i], order[(i + 1) % n]));
+    }
+    return acc;
+}
+
+static double routeLength(const std::vector<CityId> &order, const Problem &problem) noexcept {
+    if (!problem.intDistanceMatrix.empty()) return static_cast<double>(tourLength(order, problem));
+    if (const double *m = problem.denseDistances()) return kernels().routeLength(order.data(), order.size(), m);
     const size_t n = order.size();
     double acc = 0.0;
     for (size_t i = 0; i + 1 < n; ++i) {
-        acc += distM[static_cast<size_t>(order[i]) * n + order[i + 1]];
+        acc += problem.distance(order[i], order[i + 1]);
     }
-    acc += distM[static_cast<size_t>(order.back()) * n + order.front()];
+    acc += problem.distance(order.back(), order.front());
     return acc;
 }
 
@@ -89,7 +236,7 @@ inline void populateCities(Problem &problem, RNG &rng, const Map &map,
         City c;
         c.x = static_cast<unsigned int>(rng.randint(0, map.width - 1));
         c.y = static_cast<unsigned int>(rng.randint(0, map.height - 1));
-        c.tag = static_cast<uint16_t>(i);
+        c.tag = static_cast<CityId>(i);
         problem.cities.push_back(c);
     }
 }
@@ -0,0 +1,157 @@
+#ifndef SALEMAN_METRICS_H
+#define SALEMAN_METRICS_H
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Endpoint HTTP no formato texto do Prometheus para execucoes longas. Cada
+// solver escreve os proprios contadores com ordem relaxed, ja sob a propria
+// trava; quem atende /metrics so le atomicos, sem tocar nas travas dos
+// solvers. Taxas (iteracoes/s, geracoes/s) ficam para rate() no Prometheus.
+
+static_assert(std::atomic<double>::is_always_lock_free, "metrics.h needs lock-free atomic<double>");
+
+struct alignas(64) SolverMetrics {
+    std::atomic<uint64_t> iterations{0}; // vizinhos avaliados (SA) ou geracoes (GA)
+    std::atomic<uint64_t> accepted{0};   // movimentos aceitos (SA)
+    std::atomic<uint64_t> stall{0};
+    std::atomic<double> best{std::numeric_limits<double>::infinity()};
+    std::atomic<double> temperature{0.0};
+    std::atomic<double> cpuSeconds{0.0};
+
+    // Tempo de CPU da thread que chama; so a thread do solver deve chamar.
+    void sampleCpu() noexcept {
+        timespec ts{};
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+            cpuSeconds.store(static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9,
+                             std::memory_order_relaxed);
+    }
+};
+
+// Memoria residente do processo, de /proc/self/statm; 0 se indisponivel.
+inline uint64_t residentMemoryBytes() {
+    std::FILE *f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long long size = 0, resident = 0;
+    const int read = std::fscanf(f, "%llu %llu", &size, &resident);
+    std::fclose(f);
+    return read == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+// Monta o corpo da resposta: HELP e TYPE uma vez por familia.
+class MetricsText {
+public:
+    MetricsText() { out.precision(15); } // contadores inteiros saem exatos
+    MetricsText &family(const char *name, const char *type, const char *help) {
+        out << "# HELP " << name << ' ' << help << "\n# TYPE " << name << ' ' << type << '\n';
+        return *this;
+    }
+    MetricsText &sample(const char *name, const double value, const std::string &labels = {}) {
+        out << name;
+        if (!labels.empty()) out << '{' << labels << '}';
+        out << ' ';
+        if (value == std::numeric_limits<double>::infinity())
+            out << "+Inf";
+        else
+            out << value;
+        out << '\n';
+        return *this;
+    }
+    [[nodiscard]] std::string str() const { return out.str(); }
+
+private:
+    std::ostringstream out;
+};
+
+// Servidor HTTP minimo em 127.0.0.1 numa thread propria: GET /metrics chama
+// render e devolve o texto; o resto recebe 404. Uma conexao por vez basta
+// para um coletor raspando a cada poucos segundos.
+class MetricsServer {
+public:
+    MetricsServer(const uint16_t port, std::function<std::string()> render) : render(std::move(render)) {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) throw std::runtime_error("MetricsServer: cannot create socket.");
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, 8) != 0 ||
+            ::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+            ::close(fd);
+            throw std::runtime_error("MetricsServer: cannot listen on 127.0.0.1:" + std::to_string(port) + ".");
+        }
+        boundPort = ntohs(addr.sin_port);
+        server = std::thread([this]() { serve(); });
+    }
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    ~MetricsServer() {
+        stopping = true;
+        server.join();
+        ::close(fd);
+    }
+
+    // Porta efetiva (util quando pedida a porta 0).
+    [[nodiscard]] uint16_t port() const noexcept { return boundPort; }
+
+private:
+    std::function<std::string()> render;
+    int fd = -1;
+    uint16_t boundPort = 0;
+    std::atomic<bool> stopping{false};
+    std::thread server;
+
+    void serve() {
+        while (!stopping) {
+            pollfd p{fd, POLLIN, 0};
+            if (::poll(&p, 1, 200) <= 0) continue;
+            const int client = ::accept(fd, nullptr, nullptr);
+            if (client < 0) continue;
+            respond(client);
+            ::close(client);
+        }
+    }
+
+    void respond(const int client) {
+        timeval timeout{1, 0};
+        ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        std::string request;
+        char chunk[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            const ssize_t r = ::recv(client, chunk, sizeof(chunk), 0);
+            if (r <= 0) return;
+            request.append(chunk, static_cast<size_t>(r));
+        }
+        const bool metrics = request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET /metrics?", 0) == 0;
+        const std::string body = metrics ? render() : "not found\n";
+        std::string response = metrics ? "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                       : "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n";
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            const ssize_t w = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) return;
+            sent += static_cast<size_t>(w);
+        }
+    }
+};
+
+#endif //SALEMAN_METRICS_H
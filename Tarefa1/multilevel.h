@@ -0,0 +1,170 @@
+#ifndef SALEMAN_MULTILEVEL_H
+#define SALEMAN_MULTILEVEL_H
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "annealing.h"
+#include "candidates.h"
+#include "genetic.h"
+#include "localsearch.h"
+#include "map.h"
+
+enum class CoarseSolver { Annealing, Genetic };
+
+struct MultilevelParams {
+    size_t coarsestSize = 200;
+    CoarseSolver coarseSolver = CoarseSolver::Annealing;
+    size_t candidateK = 8;
+    size_t denseLimit = 2000; // niveis ate esse tamanho usam matriz densa
+    uint64_t seed = 1;
+    const AnnealingParams *annealing = nullptr; // nullptr: defaultAnnealingParams do nivel mais grosso
+    const GAParams *genetic = nullptr;          // nullptr: defaultGAParams do nivel mais grosso
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(); // buscas locais
+};
+
+// Um nivel grosso: cada cidade representa um par de cidades do nivel mais
+// fino unidas por uma aresta fixa, ou uma cidade que ficou sem par.
+struct CoarseLevel {
+    Problem problem;
+    std::vector<std::array<CityId, 2>> children;
+};
+
+// Candidatos e, nos niveis pequenos, matriz densa de um nivel contraido.
+inline void prepareLevel(Problem &problem, const MultilevelParams &params) {
+    problem.candidates = buildNearestNeighborCandidates(problem, params.candidateK);
+    if (problem.numCities() <= params.denseLimit) buildDenseMatrix(problem);
+}
+
+// Contrai pares de vizinhos mutuamente mais proximos; as cidades que sobram
+// sao pareadas com o candidato livre mais proximo.
+inline CoarseLevel coarsen(const Problem &fine) {
+    constexpr CityId none = std::numeric_limits<CityId>::max();
+    const size_t n = fine.numCities();
+    const CandidateGraph &g = fine.candidates;
+    std::vector<CityId> mate(n, none);
+
+    auto nearest = [&](const size_t i) { return g.degree(i) ? g.neighbors[g.offsets[i]] : none; };
+    for (size_t i = 0; i < n; ++i) {
+        const CityId j = nearest(i);
+        if (j != none && mate[i] == none && mate[j] == none && nearest(j) == i) {
+            mate[i] = j;
+            mate[j] = static_cast<CityId>(i);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (mate[i] != none) continue;
+        for (uint32_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+            const CityId j = g.neighbors[k];
+            if (mate[j] == none) {
+                mate[i] = j;
+                mate[j] = static_cast<CityId>(i);
+                break;
+            }
+        }
+    }
+
+    CoarseLevel level;
+    level.problem.map = fine.map;
+    level.problem.metric = fine.metric;
+    for (size_t i = 0; i < n; ++i) {
+        const CityId j = mate[i];
+        if (j != none && j < i) continue;
+        City c;
+        if (j == none) {
+            c.x = fine.cities[i].x;
+            c.y = fine.cities[i].y;
+        } else {
+            c.x = fine.cities[i].x / 2 + fine.cities[j].x / 2 + (fine.cities[i].x & fine.cities[j].x & 1u);
+            c.y = fine.cities[i].y / 2 + fine.cities[j].y / 2 + (fine.cities[i].y & fine.cities[j].y & 1u);
+        }
+        c.tag = static_cast<CityId>(level.problem.cities.size());
+        level.problem.cities.push_back(c);
+        level.children.push_back({static_cast<CityId>(i), j});
+    }
+    return level;
+}
+
+// Expande o tour grosso para o nivel fino, orientando cada par de forma a
+// ligar-se melhor a cidade anterior.
+inline Path uncoarsen(const Path &coarse, const CoarseLevel &level, const Problem &fine) {
+    constexpr CityId none = std::numeric_limits<CityId>::max();
+    Path path;
+    path.order.reserve(fine.numCities());
+    for (const CityId c : coarse.order) {
+        const auto &[a, b] = level.children[c];
+        if (b == none) {
+            path.order.push_back(a);
+        } else if (path.order.empty() ||
+                   fine.distance(path.order.back(), a) <= fine.distance(path.order.back(), b)) {
+            path.order.push_back(a);
+            path.order.push_back(b);
+        } else {
+            path.order.push_back(b);
+            path.order.push_back(a);
+        }
+    }
+    return path;
+}
+
+// Resolvedor multinivel: constroi a hierarquia de problemas contraidos,
+// resolve o mais grosso com SA ou GA e refina nivel a nivel com busca local.
+// O problema precisa do grafo de candidatos (prepareProblem ou
+// buildNearestNeighborCandidates); os niveis contraidos montam os seus.
+inline Path runMultilevel(const Problem &problem, const MultilevelParams &params) {
+    if (problem.numCities() < 3) throw std::runtime_error("Need at least 3 cities.");
+    if (problem.candidates.empty()) throw std::runtime_error("runMultilevel needs a candidate graph.");
+
+    std::vector<CoarseLevel> levels;
+    const Problem *current = &problem;
+    while (current->numCities() > std::max<size_t>(params.coarsestSize, 8)) {
+        CoarseLevel level = coarsen(*current);
+        if (level.problem.numCities() * 20 > current->numCities() * 19) break; // reducao < 5%
+        prepareLevel(level.problem, params);
+        levels.push_back(std::move(level));
+        current = &levels.back().problem;
+    }
+
+    RNG rng(params.seed);
+    const Problem &coarsest = levels.empty() ? problem : levels.back().problem;
+    const size_t m = coarsest.numCities();
+    LocalSearchParams lsParams;
+    lsParams.deadline = params.deadline;
+
+    Path path;
+    if (params.coarseSolver == CoarseSolver::Genetic) {
+        GAState state;
+        state.params = params.genetic ? *params.genetic : defaultGAParams(m);
+        state.params.deadline = params.deadline;
+        initGA(state, coarsest, rng);
+        while (stepGA(state, coarsest, rng)) {
+        }
+        path = state.bestPath;
+    } else {
+        AnnealingState state;
+        state.problem = &coarsest;
+        state.params = params.annealing ? *params.annealing : defaultAnnealingParams(m);
+        state.params.actualTemp = state.params.initialTemp;
+        state.currentPath.order.resize(m);
+        std::iota(state.currentPath.order.begin(), state.currentPath.order.end(), 0);
+        std::shuffle(state.currentPath.order.begin(), state.currentPath.order.end(), rng.eng);
+        state.currentPath.dist = routeLength(state.currentPath.order, coarsest);
+        state.bestPath = state.currentPath;
+        state.bestDist = state.currentPath.dist;
+        path = anneal(state, rng);
+    }
+    localSearch(path, coarsest, lsParams);
+
+    for (size_t l = levels.size(); l-- > 0;) {
+        const Problem &fine = l == 0 ? problem : levels[l - 1].problem;
+        path = uncoarsen(path, levels[l], fine);
+        localSearch(path, fine, lsParams);
+    }
+    return path;
+}
+
+#endif //SALEMAN_MULTILEVEL_H
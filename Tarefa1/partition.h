@@ -0,0 +1,210 @@
+#ifndef SALEMAN_PARTITION_H
+#define SALEMAN_PARTITION_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "annealing.h"
+#include "candidates.h"
+#include "genetic.h"
+#include "hilbert.h"
+#include "localsearch.h"
+#include "map.h"
+
+enum class SubSolver { Annealing, Genetic, LocalSearch };
+
+struct PartitionParams {
+    size_t leafSize = 1000;
+    SubSolver subSolver = SubSolver::LocalSearch;
+    unsigned int threads = 0; // 0 = std::thread::hardware_concurrency()
+    uint64_t seed = 1;
+    size_t candidateK = 8;
+    const AnnealingParams *annealing = nullptr; // nullptr: defaultAnnealingParams do tamanho da folha
+    const GAParams *genetic = nullptr;          // nullptr: defaultGAParams do tamanho da folha
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max(); // buscas locais
+};
+
+// Divide recursivamente as cidades pelo eixo mais longo da regiao, na
+// mediana, ate que cada folha tenha no maximo leafSize cidades (Karp).
+inline void partitionCities(const Problem &problem, std::vector<CityId> &ids, const size_t begin,
+                            const size_t end, const size_t leafSize,
+                            std::vector<std::vector<CityId>> &leaves) {
+    if (end - begin <= leafSize) {
+        leaves.emplace_back(ids.begin() + begin, ids.begin() + end);
+        return;
+    }
+    unsigned int minX = problem.cities[ids[begin]].x, maxX = minX;
+    unsigned int minY = problem.cities[ids[begin]].y, maxY = minY;
+    for (size_t i = begin; i < end; ++i) {
+        const City &c = problem.cities[ids[i]];
+        minX = std::min(minX, c.x);
+        maxX = std::max(maxX, c.x);
+        minY = std::min(minY, c.y);
+        maxY = std::max(maxY, c.y);
+    }
+    const bool splitX = (maxX - minX) >= (maxY - minY);
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end,
+                     [&](const CityId a, const CityId b) {
+                         return splitX ? problem.cities[a].x < problem.cities[b].x
+                                       : problem.cities[a].y < problem.cities[b].y;
+                     });
+    partitionCities(problem, ids, begin, mid, leafSize, leaves);
+    partitionCities(problem, ids, mid, end, leafSize, leaves);
+}
+
+// Resolve o subproblema de uma folha e devolve o ciclo em indices globais.
+inline std::vector<CityId> solveLeaf(const Problem &problem, const std::vector<CityId> &ids,
+                                     const PartitionParams &params, RNG &rng) {
+    if (ids.size() < 4) return ids;
+
+    Problem sub;
+    sub.map = problem.map;
+    sub.metric = problem.metric;
+    sub.cities.reserve(ids.size());
+    for (const CityId id : ids) {
+        City c = problem.cities[id];
+        c.tag = id; // tag guarda o indice global
+        sub.cities.push_back(c);
+    }
+    buildDenseMatrix(sub);
+    sub.candidates = buildNearestNeighborCandidates(sub, params.candidateK);
+
+    Path tour;
+    switch (params.subSolver) {
+    case SubSolver::Genetic:
+        tour = runGA(sub, params.genetic ? *params.genetic : defaultGAParams(sub.numCities()), rng);
+        break;
+    case SubSolver::Annealing: {
+        AnnealingState state;
+        state.problem = &sub;
+        state.params = params.annealing ? *params.annealing : defaultAnnealingParams(sub.numCities());
+        state.params.actualTemp = state.params.initialTemp;
+        state.currentPath = greedyEdgeTour(sub);
+        state.bestPath = state.currentPath;
+        state.bestDist = state.currentPath.dist;
+        tour = anneal(state, rng);
+        break;
+    }
+    case SubSolver::LocalSearch:
+        tour = greedyEdgeTour(sub);
+        break;
+    }
+    LocalSearchParams lsParams;
+    lsParams.deadline = params.deadline;
+    localSearch(tour, sub, lsParams);
+
+    std::vector<CityId> global;
+    global.reserve(tour.order.size());
+    for (const CityId local : tour.order) global.push_back(sub.cities[local].tag);
+    return global;
+}
+
+// Modo dividir-e-conquistar para instancias enormes: particiona o plano em
+// regioes balanceadas, resolve cada uma em paralelo, costura os sub-tours na
+// ordem de Hilbert das regioes e repara as fronteiras com busca local. O
+// problema precisa do grafo de candidatos (prepareProblem ou
+// buildNearestNeighborCandidates), usado no reparo.
+inline Path runPartitioned(const Problem &problem, const PartitionParams &params) {
+    const size_t n = problem.numCities();
+    if (n < 3) throw std::runtime_error("Need at least 3 cities.");
+    if (problem.candidates.empty()) throw std::runtime_error("runPartitioned needs a candidate graph.");
+
+    std::vector<CityId> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::vector<std::vector<CityId>> leaves;
+    partitionCities(problem, ids, 0, n, std::max<size_t>(params.leafSize, 4), leaves);
+
+    // ordena as folhas pela curva de Hilbert dos centroides para que folhas
+    // consecutivas sejam vizinhas no plano
+    Problem centroids;
+    for (const auto &leaf : leaves) {
+        double sx = 0.0, sy = 0.0;
+        for (const CityId id : leaf) {
+            sx += problem.cities[id].x;
+            sy += problem.cities[id].y;
+        }
+        City c;
+        c.x = static_cast<unsigned int>(sx / static_cast<double>(leaf.size()));
+        c.y = static_cast<unsigned int>(sy / static_cast<double>(leaf.size()));
+        centroids.cities.push_back(c);
+    }
+    const std::vector<size_t> leafOrder = hilbertOrder(centroids);
+
+    std::vector<std::vector<CityId>> subTours(leaves.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t l = next++; l < leaves.size(); l = next++) {
+            RNG rng(params.seed ^ (0x9E3779B97F4A7C15ULL * (l + 1)));
+            subTours[l] = solveLeaf(problem, leaves[l], params, rng);
+        }
+    };
+    const unsigned int threads = std::max(1u, params.threads ? params.threads
+                                                             : std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < std::min<size_t>(threads, leaves.size()); ++t) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+
+    // costura: cada ciclo e aberto na aresta que minimiza a ligacao com a
+    // saida da folha anterior
+    Path path;
+    path.order.reserve(n);
+    for (const size_t l : leafOrder) {
+        const std::vector<CityId> &t = subTours[l];
+        const size_t m = t.size();
+        if (path.order.empty()) {
+            path.order.insert(path.order.end(), t.begin(), t.end());
+            continue;
+        }
+        const CityId exit = path.order.back();
+        double best = std::numeric_limits<double>::infinity();
+        size_t cut = 0;
+        bool forward = true;
+        for (size_t k = 0; k < m; ++k) {
+            const CityId a = t[k], b = t[(k + 1) % m];
+            const double removed = m > 1 ? problem.distance(a, b) : 0.0;
+            const double fwd = problem.distance(exit, b) - removed;
+            const double bwd = problem.distance(exit, a) - removed;
+            if (fwd < best) {
+                best = fwd;
+                cut = k;
+                forward = true;
+            }
+            if (bwd < best) {
+                best = bwd;
+                cut = k;
+                forward = false;
+            }
+        }
+        for (size_t s = 0; s < m; ++s) {
+            path.order.push_back(forward ? t[(cut + 1 + s) % m] : t[(cut + m - s) % m]);
+        }
+    }
+
+    // reparo das fronteiras: ativa apenas cidades com candidatos em outra folha
+    std::vector<uint32_t> leafOf(n);
+    for (size_t l = 0; l < leaves.size(); ++l) {
+        for (const CityId id : leaves[l]) leafOf[id] = static_cast<uint32_t>(l);
+    }
+    std::vector<CityId> boundary;
+    const CandidateGraph &g = problem.candidates;
+    for (size_t i = 0; i < n; ++i) {
+        for (uint32_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+            if (leafOf[g.neighbors[k]] != leafOf[i]) {
+                boundary.push_back(static_cast<CityId>(i));
+                break;
+            }
+        }
+    }
+    LocalSearchParams lsParams;
+    lsParams.deadline = params.deadline;
+    localSearch(path, problem, lsParams, &boundary);
+    return path;
+}
+
+#endif //SALEMAN_PARTITION_H
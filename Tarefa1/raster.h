@@ -0,0 +1,172 @@
+#ifndef SALEMAN_RASTER_H
+#define SALEMAN_RASTER_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Rasterizador em CPU para exportar quadros sem janela: um buffer RGBA e as
+// poucas primitivas que o visualizador usa (retangulos, linhas grossas,
+// circulos e texto em fonte bitmap 5x7). Sem antialiasing; alpha e misturado
+// sobre o que ja estiver no buffer.
+
+struct Rgba {
+    uint8_t r, g, b, a;
+};
+
+struct Canvas {
+    int width = 0, height = 0;
+    std::vector<uint8_t> pixels; // RGBA, linha a linha
+};
+
+inline void resizeCanvas(Canvas &canvas, const int width, const int height) {
+    canvas.width = width;
+    canvas.height = height;
+    canvas.pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+}
+
+inline void clearCanvas(Canvas &canvas, const Rgba c) {
+    for (size_t i = 0; i < canvas.pixels.size(); i += 4) {
+        canvas.pixels[i] = c.r;
+        canvas.pixels[i + 1] = c.g;
+        canvas.pixels[i + 2] = c.b;
+        canvas.pixels[i + 3] = c.a;
+    }
+}
+
+inline void blendPixel(Canvas &canvas, const int x, const int y, const Rgba c) {
+    if (x < 0 || y < 0 || x >= canvas.width || y >= canvas.height) return;
+    uint8_t *p = &canvas.pixels[(static_cast<size_t>(y) * canvas.width + x) * 4];
+    if (c.a == 255) {
+        p[0] = c.r;
+        p[1] = c.g;
+        p[2] = c.b;
+        p[3] = 255;
+        return;
+    }
+    const int a = c.a, ia = 255 - c.a;
+    p[0] = static_cast<uint8_t>((c.r * a + p[0] * ia) / 255);
+    p[1] = static_cast<uint8_t>((c.g * a + p[1] * ia) / 255);
+    p[2] = static_cast<uint8_t>((c.b * a + p[2] * ia) / 255);
+    p[3] = static_cast<uint8_t>(std::min(255, a + p[3] * ia / 255));
+}
+
+inline void fillRect(Canvas &canvas, const int x, const int y, const int w, const int h, const Rgba c) {
+    const int x0 = std::max(0, x), y0 = std::max(0, y);
+    const int x1 = std::min(canvas.width, x + w), y1 = std::min(canvas.height, y + h);
+    for (int py = y0; py < y1; ++py) {
+        for (int px = x0; px < x1; ++px) blendPixel(canvas, px, py, c);
+    }
+}
+
+// Contorno de 1 pixel, como DrawRectangleLines.
+inline void strokeRect(Canvas &canvas, const int x, const int y, const int w, const int h, const Rgba c) {
+    fillRect(canvas, x, y, w, 1, c);
+    fillRect(canvas, x, y + h - 1, w, 1, c);
+    fillRect(canvas, x, y + 1, 1, h - 2, c);
+    fillRect(canvas, x + w - 1, y + 1, 1, h - 2, c);
+}
+
+inline void fillCircle(Canvas &canvas, const float cx, const float cy, const float radius, const Rgba c) {
+    const int x0 = static_cast<int>(std::floor(cx - radius)), x1 = static_cast<int>(std::ceil(cx + radius));
+    const int y0 = static_cast<int>(std::floor(cy - radius)), y1 = static_cast<int>(std::ceil(cy + radius));
+    const float r2 = radius * radius;
+    for (int py = y0; py <= y1; ++py) {
+        for (int px = x0; px <= x1; ++px) {
+            const float dx = static_cast<float>(px) + 0.5f - cx, dy = static_cast<float>(py) + 0.5f - cy;
+            if (dx * dx + dy * dy <= r2) blendPixel(canvas, px, py, c);
+        }
+    }
+}
+
+// Linha com espessura: um quadrado de lado thick a cada passo de um pixel ao
+// longo do segmento. Cores opacas apenas, para nao acumular alpha.
+inline void drawLine(Canvas &canvas, const float ax, const float ay, const float bx, const float by,
+                     const float thick, const Rgba c) {
+    const float dx = bx - ax, dy = by - ay;
+    const int steps = std::max(1, static_cast<int>(std::ceil(std::max(std::fabs(dx), std::fabs(dy)))));
+    const int side = std::max(1, static_cast<int>(std::lround(thick)));
+    const float half = static_cast<float>(side) * 0.5f;
+    for (int s = 0; s <= steps; ++s) {
+        const float t = static_cast<float>(s) / static_cast<float>(steps);
+        const int px = static_cast<int>(std::floor(ax + dx * t - half + 0.5f));
+        const int py = static_cast<int>(std::floor(ay + dy * t - half + 0.5f));
+        fillRect(canvas, px, py, side, side, c);
+    }
+}
+
+// Polilinha com pontos {x, y} em float (Vector2 ou equivalente).
+template <typename P>
+inline void drawPolyline(Canvas &canvas, const std::vector<P> &points, const float thick, const Rgba c) {
+    for (size_t i = 1; i < points.size(); ++i) {
+        drawLine(canvas, points[i - 1].x, points[i - 1].y, points[i].x, points[i].y, thick, c);
+    }
+}
+
+// Fonte 5x7 para ASCII 32..126, uma coluna por byte com o bit 0 no topo.
+inline const uint8_t *glyph5x7(const char ch) noexcept {
+    static constexpr uint8_t font[95][5] = {
+        {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+        {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+        {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+        {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+        {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+        {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+        {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+        {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+        {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+        {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+        {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+        {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+        {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x01, 0x01},
+        {0x3E, 0x41, 0x41, 0x51, 0x32}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+        {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+        {0x7F, 0x02, 0x04, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+        {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+        {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+        {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x7F, 0x20, 0x18, 0x20, 0x7F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+        {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+        {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+        {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+        {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+        {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+        {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+        {0x00, 0x7F, 0x10, 0x28, 0x44}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+        {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+        {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+        {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+        {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+        {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+        {0x00, 0x41, 0x36, 0x08, 0x00}, {0x10, 0x08, 0x08, 0x10, 0x08},
+    };
+    const int i = static_cast<unsigned char>(ch) - 32;
+    return font[(i >= 0 && i < 95) ? i : '?' - 32];
+}
+
+// Celula de 6x10 (glifo e espacamento) na escala size / 10, como a fonte
+// padrao da raylib, para que o layout do visualizador caiba igual.
+inline int measureText(const std::string &text, const int size) noexcept {
+    return static_cast<int>(std::lround(static_cast<double>(text.size()) * 6.0 * size / 10.0));
+}
+
+inline void drawText(Canvas &canvas, const std::string &text, const int x, const int y, const int size, const Rgba c) {
+    const double scale = size / 10.0;
+    const int cellW = static_cast<int>(std::lround(6.0 * scale));
+    const int cellH = static_cast<int>(std::lround(10.0 * scale));
+    for (size_t k = 0; k < text.size(); ++k) {
+        const uint8_t *g = glyph5x7(text[k]);
+        const int x0 = x + static_cast<int>(std::lround(static_cast<double>(k) * 6.0 * scale));
+        // uma linha de respiro no topo, como na fonte da raylib
+        for (int py = 0; py < cellH; ++py) {
+            const int row = static_cast<int>(py / scale) - 1;
+            if (row < 0 || row >= 7) continue;
+            for (int px = 0; px < cellW; ++px) {
+                const int col = static_cast<int>(px / scale);
+                if (col < 5 && (g[col] >> row & 1)) blendPixel(canvas, x0 + px, y + py, c);
+            }
+        }
+    }
+}
+
+#endif //SALEMAN_RASTER_H
@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "instance_io.h"
+#include "solver.h"
+
+#define REGRESS_DENSE_MATRIX_LIMIT 6000
+
+namespace {
+
+// Otimos conhecidos do TSPLIB (EUC_2D/CEIL_2D), por NAME.
+const std::map<std::string, double> knownOptima = {
+    {"eil51", 426},       {"berlin52", 7542},   {"st70", 675},        {"eil76", 538},       {"pr76", 108159},
+    {"rat99", 1211},      {"kroA100", 21282},   {"kroB100", 22141},   {"kroC100", 20749},   {"kroD100", 21294},
+    {"kroE100", 22068},   {"rd100", 7910},      {"eil101", 629},      {"lin105", 14379},    {"pr107", 44303},
+    {"pr124", 59030},     {"ch130", 6110},      {"pr136", 96772},     {"pr144", 58537},     {"ch150", 6528},
+    {"kroA150", 26524},   {"pr152", 73682},     {"u159", 42080},      {"rat195", 2323},     {"d198", 15780},
+    {"kroA200", 29368},   {"ts225", 126643},    {"tsp225", 3916},     {"pr226", 80369},     {"a280", 2579},
+    {"pr264", 49135},     {"lin318", 42029},    {"rd400", 15281},     {"fl417", 11861},     {"pr439", 107217},
+    {"pcb442", 50778},    {"d493", 35002},      {"rat575", 6773},     {"u574", 36905},      {"p654", 34643},
+    {"d657", 48912},      {"u724", 41910},      {"rat783", 8806},     {"pr1002", 259045},   {"u1060", 224094},
+    {"vm1084", 239297},   {"pcb1173", 56892},   {"d1291", 50801},     {"rl1304", 252948},   {"rl1323", 270199},
+    {"nrw1379", 56638},   {"fl1400", 20127},    {"u1432", 152970},    {"fl1577", 22249},    {"d1655", 62128},
+    {"vm1748", 336556},   {"u1817", 57201},     {"rl1889", 316536},   {"d2103", 80450},     {"u2152", 64253},
+    {"u2319", 234256},    {"pr2392", 378032},   {"pcb3038", 137694},  {"fl3795", 28772},    {"fnl4461", 182566},
+    {"rl5915", 565530},   {"rl5934", 556045},   {"rl11849", 923288},  {"usa13509", 19982859}, {"d15112", 1573084}};
+
+// Corpus fixo: um diretorio passado sem --all contribui exatamente estas
+// instancias, para que "saleman_regress <dir>" rode sempre o mesmo conjunto e
+// a linha de base continue comparavel.
+const std::vector<std::string> regressCorpus = {"eil51", "berlin52", "kroA100", "pr1002", "rl5915"};
+
+struct Options {
+    double budget = 2.0;  // segundos por execucao
+    size_t seeds = 5;
+    std::vector<Algorithm> algorithms{Algorithm::Annealing, Algorithm::Genetic,     Algorithm::LocalSearch,
+                                      Algorithm::Hybrid,    Algorithm::Partitioned, Algorithm::Multilevel};
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string baseline = "regress_baseline.csv";
+    bool update = false;         // grava o resultado como nova linha de base
+    bool all = false;            // diretorios contribuem com todos os .tsp, nao so o corpus
+    double gapTolerance = 0.5;   // pontos percentuais de desvio medio a mais
+    double speedTolerance = 0.2; // fracao de vazao a menos
+    std::map<std::string, double> optima = knownOptima;
+    std::vector<std::string> paths;
+};
+
+struct Instance {
+    std::string name;
+    Problem problem;
+    double optimum;
+};
+
+struct Run {
+    size_t instance, algorithm;
+    uint64_t seed;
+    double length = 0.0;
+    double timeToBest = 0.0;
+    double stepsPerSecond = 0.0;
+};
+
+// Resumo por instancia e algoritmo; e o que vai para a linha de base.
+struct Summary {
+    double meanGap = 0.0, bestGap = 0.0; // em %
+    double meanTimeToBest = 0.0;         // segundos
+    double stepsPerSecond = 0.0;         // media das execucoes
+};
+
+template <typename T, typename F>
+std::vector<T> splitList(const std::string &s, F &&parse)
+{
+    std::vector<T> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) out.push_back(parse(item));
+    return out;
+}
+
+std::string key(const std::string &instance, const Algorithm algorithm)
+{
+    return instance + "," + algorithmName(algorithm);
+}
+
+// Linha de base: instance,algorithm,mean_gap_pct,best_gap_pct,time_to_best_s,steps_per_s
+std::map<std::string, Summary> readBaseline(const std::string &path)
+{
+    std::map<std::string, Summary> baseline;
+    std::ifstream in(path);
+    if (!in) return baseline;
+    std::string line;
+    std::getline(in, line); // cabecalho
+    while (std::getline(in, line))
+    {
+        std::stringstream ss(line);
+        std::string instance, algorithm, field;
+        Summary s;
+        if (!std::getline(ss, instance, ',') || !std::getline(ss, algorithm, ',')) continue;
+        double *fields[] = {&s.meanGap, &s.bestGap, &s.meanTimeToBest, &s.stepsPerSecond};
+        for (double *f : fields)
+        {
+            if (!std::getline(ss, field, ',')) throw std::runtime_error("malformed baseline line: " + line);
+            *f = std::stod(field);
+        }
+        baseline[instance + "," + algorithm] = s;
+    }
+    return baseline;
+}
+
+} // namespace
+
+// saleman_regress [--budget s] [--seeds k] [--algorithms sa,ga,ls,hy,pt,ml] [--threads t] [--baseline arquivo.csv]
+//                 [--update] [--gap-tolerance pp] [--speed-tolerance f] [--optimum nome=valor] [--all]
+//                 arquivos/diretorios...
+// Regressao sobre um corpus TSPLIB com otimos conhecidos: cada algoritmo roda
+// k sementes por instancia com o mesmo orcamento. Registra desvio para o
+// otimo, tempo ate o melhor tour e vazao (passos do solver por segundo) e
+// compara com a linha de base: desvio medio acima da tolerancia (pontos
+// percentuais) e regressao de qualidade; vazao abaixo de (1 - f) vezes a da
+// base e regressao de velocidade. Sai com 1 se houver alguma; --update
+// regrava a linha de base. Por padrao rodam os seis algoritmos, e um
+// diretorio entra com as instancias de regressCorpus (todos os .tsp com
+// --all); arquivos avulsos entram como dados.
+int main(int argc, char** argv)
+{
+    Options opt;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--budget") == 0 && hasValue) opt.budget = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--seeds") == 0 && hasValue) opt.seeds = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--algorithms") == 0 && hasValue)
+                opt.algorithms = splitList<Algorithm>(argv[++i], [](const std::string& s) { return parseAlgorithm(s); });
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) opt.threads = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) opt.baseline = argv[++i];
+            else if (std::strcmp(argv[i], "--update") == 0) opt.update = true;
+            else if (std::strcmp(argv[i], "--all") == 0) opt.all = true;
+            else if (std::strcmp(argv[i], "--gap-tolerance") == 0 && hasValue) opt.gapTolerance = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--speed-tolerance") == 0 && hasValue) opt.speedTolerance = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--optimum") == 0 && hasValue)
+            {
+                const std::string arg = argv[++i];
+                const size_t eq = arg.find('=');
+                if (eq == std::string::npos) throw std::runtime_error("--optimum expects name=value.");
+                opt.optima[arg.substr(0, eq)] = std::stod(arg.substr(eq + 1));
+            }
+            else opt.paths.push_back(argv[i]);
+        }
+        if (!(opt.budget > 0.0) || opt.seeds == 0 || opt.threads == 0 || opt.algorithms.empty())
+            throw std::runtime_error("need --budget, --seeds, --threads and --algorithms to be non-empty/positive.");
+
+        // diretorios contribuem com o corpus fixo, ou com todos os seus .tsp
+        // em ordem de nome
+        std::vector<std::string> files;
+        for (const std::string& path : opt.paths)
+        {
+            if (!std::filesystem::is_directory(path))
+            {
+                files.push_back(path);
+                continue;
+            }
+            if (!opt.all)
+            {
+                for (const std::string& name : regressCorpus)
+                {
+                    const std::filesystem::path file = std::filesystem::path(path) / (name + ".tsp");
+                    if (!std::filesystem::is_regular_file(file))
+                        throw std::runtime_error("corpus instance " + file.string() + " not found (or use --all).");
+                    files.push_back(file.string());
+                }
+                continue;
+            }
+            std::vector<std::string> found;
+            for (const auto& entry : std::filesystem::directory_iterator(path))
+                if (entry.path().extension() == ".tsp") found.push_back(entry.path().string());
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        }
+        if (files.empty()) throw std::runtime_error("no TSPLIB instances given.");
+
+        std::vector<Instance> instances;
+        for (const std::string& file : files)
+        {
+            Instance inst;
+            inst.problem = readTSPLIB(file, &inst.name);
+            if (inst.name.empty()) inst.name = std::filesystem::path(file).stem().string();
+            const auto it = opt.optima.find(inst.name);
+            if (it == opt.optima.end())
+                throw std::runtime_error("no known optimum for " + inst.name + " (use --optimum " + inst.name + "=value).");
+            inst.optimum = it->second;
+            prepareProblem(inst.problem, REGRESS_DENSE_MATRIX_LIMIT);
+            instances.push_back(std::move(inst));
+        }
+
+        std::vector<Run> runs;
+        for (size_t i = 0; i < instances.size(); ++i)
+            for (size_t a = 0; a < opt.algorithms.size(); ++a)
+                for (size_t s = 0; s < opt.seeds; ++s) runs.push_back({i, a, s + 1});
+
+        std::printf("kernels: %s, threads: %zu, %zu runs of %.2f s\n", isaName(kernels().isa), opt.threads,
+                    runs.size(), opt.budget);
+        std::fflush(stdout);
+
+        const auto budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(opt.budget));
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t r = next++; r < runs.size(); r = next++)
+            {
+                Run& run = runs[r];
+                const Problem& problem = instances[run.instance].problem;
+                uint64_t steps = 0;
+                SolveParams params;
+                params.algorithm = opt.algorithms[run.algorithm];
+                params.steps = &steps;
+                const auto start = std::chrono::steady_clock::now();
+                params.deadline = start + budget;
+                SolverObserver observer;
+                observer.onImprovement = [&](const Path&, uint64_t) {
+                    run.timeToBest = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    return true;
+                };
+                params.observer = &observer;
+                RNG rng(run.seed);
+                const Path best = solveTimed(problem, params, rng);
+                const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                run.length = integralMetric(problem.metric) ? static_cast<double>(tourLength(best.order, problem))
+                                                            : routeLength(best.order, problem);
+                run.stepsPerSecond = static_cast<double>(steps) / elapsed;
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < std::min(opt.threads, runs.size()); ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+
+        std::map<std::string, Summary> current;
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            for (size_t a = 0; a < opt.algorithms.size(); ++a)
+            {
+                Summary s;
+                s.bestGap = std::numeric_limits<double>::infinity();
+                for (const Run& run : runs)
+                {
+                    if (run.instance != i || run.algorithm != a) continue;
+                    const double gap = 100.0 * (run.length / instances[i].optimum - 1.0);
+                    s.meanGap += gap;
+                    s.bestGap = std::min(s.bestGap, gap);
+                    s.meanTimeToBest += run.timeToBest;
+                    s.stepsPerSecond += run.stepsPerSecond;
+                }
+                const double k = static_cast<double>(opt.seeds);
+                s.meanGap /= k;
+                s.meanTimeToBest /= k;
+                s.stepsPerSecond /= k;
+                current[key(instances[i].name, opt.algorithms[a])] = s;
+            }
+        }
+
+        const std::map<std::string, Summary> baseline = readBaseline(opt.baseline);
+        size_t regressions = 0;
+        std::printf("%-12s %-4s %9s %9s %9s %12s %9s %9s  %s\n", "instance", "alg", "gap%", "best%", "ttb (s)",
+                    "steps/s", "base gap", "speed", "status");
+        for (const Instance& inst : instances)
+        {
+            for (const Algorithm algorithm : opt.algorithms)
+            {
+                const Summary& s = current[key(inst.name, algorithm)];
+                const auto it = baseline.find(key(inst.name, algorithm));
+                std::string status = "new";
+                char baseGap[32] = "-", speed[32] = "-";
+                if (it != baseline.end())
+                {
+                    const Summary& b = it->second;
+                    const double ratio = b.stepsPerSecond > 0.0 ? s.stepsPerSecond / b.stepsPerSecond : 1.0;
+                    std::snprintf(baseGap, sizeof(baseGap), "%.3f", b.meanGap);
+                    std::snprintf(speed, sizeof(speed), "%.2fx", ratio);
+                    const bool quality = s.meanGap > b.meanGap + opt.gapTolerance;
+                    const bool slow = ratio < 1.0 - opt.speedTolerance;
+                    status = quality && slow ? "QUALITY+SPEED" : quality ? "QUALITY" : slow ? "SPEED" : "ok";
+                    regressions += quality || slow;
+                }
+                std::printf("%-12s %-4s %9.3f %9.3f %9.3f %12.1f %9s %9s  %s\n", inst.name.c_str(),
+                            algorithmName(algorithm), s.meanGap, s.bestGap, s.meanTimeToBest, s.stepsPerSecond,
+                            baseGap, speed, status.c_str());
+            }
+        }
+
+        if (opt.update)
+        {
+            // preserva entradas da base que nao rodaram agora
+            std::map<std::string, Summary> merged = baseline;
+            for (const auto& [k, s] : current) merged[k] = s;
+            std::ofstream out(opt.baseline);
+            if (!out) throw std::runtime_error("cannot write " + opt.baseline + ".");
+            out.precision(10);
+            out << "instance,algorithm,mean_gap_pct,best_gap_pct,time_to_best_s,steps_per_s\n";
+            for (const auto& [k, s] : merged)
+                out << k << ',' << s.meanGap << ',' << s.bestGap << ',' << s.meanTimeToBest << ','
+                    << s.stepsPerSecond << '\n';
+            std::printf("wrote %s\n", opt.baseline.c_str());
+            return 0;
+        }
+        if (baseline.empty()) std::printf("no baseline at %s (run with --update to create it)\n", opt.baseline.c_str());
+        if (regressions)
+        {
+            std::printf("%zu regression(s)\n", regressions);
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_regress: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#ifndef SALEMAN_H
+#define SALEMAN_H
+/*
+ * API C estavel da libsaleman. Os solvers rodam na thread de quem chama, com
+ * orcamento de tempo, e escrevem o tour em um buffer do chamador.
+ *
+ * Entradas:
+ *  - saleman_solve_matrix usa a matriz n x n (linha a linha, double) direto da
+ *    memoria do chamador, sem copia; ela precisa continuar valida e inalterada
+ *    durante a chamada. Sem coordenadas nao ha grafo de candidatos, entao
+ *    SALEMAN_PARTITIONED e SALEMAN_MULTILEVEL sao recusados (SALEMAN_EINVAL).
+ *  - saleman_solve_coords leva as coordenadas, em qualquer escala, para a
+ *    grade inteira usada internamente (o maior lado vira 2^24 unidades) e
+ *    monta candidatos e matriz como o executavel. O comprimento devolvido e
+ *    o do callback ficam nas unidades do chamador.
+ *
+ * Todas as funcoes devolvem SALEMAN_OK ou um codigo negativo; a mensagem fica
+ * em saleman_last_error(), por thread. Nenhuma excecao atravessa a API.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define SALEMAN_API __declspec(dllexport)
+#else
+#define SALEMAN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SALEMAN_API_VERSION 1
+
+enum {
+    SALEMAN_OK = 0,
+    SALEMAN_EINVAL = -1,   /* argumento invalido */
+    SALEMAN_ENOMEM = -2,
+    SALEMAN_EINTERNAL = -3
+};
+
+typedef enum {
+    SALEMAN_ANNEALING = 0,
+    SALEMAN_GENETIC = 1,
+    SALEMAN_LOCAL_SEARCH = 2,
+    SALEMAN_HYBRID = 3,      /* GA com busca local no melhor individuo */
+    SALEMAN_PARTITIONED = 4, /* busca local iterada a partir do tour particionado; so coordenadas */
+    SALEMAN_MULTILEVEL = 5   /* busca local iterada a partir do tour multinivel; so coordenadas */
+} saleman_algorithm;
+
+/*
+ * Chamado na thread do solver quando o melhor tour melhora, no maximo uma vez
+ * por progress_interval_ms. Devolver diferente de zero interrompe a busca; o
+ * melhor tour ate ali ainda e escrito.
+ */
+typedef int (*saleman_progress_fn)(double best_length, double elapsed_seconds, void *user);
+
+typedef struct {
+    uint32_t struct_size; /* sizeof(saleman_options), preenchido por saleman_default_options */
+    saleman_algorithm algorithm;
+    double time_budget;   /* segundos */
+    uint64_t seed;        /* 0 = semente aleatoria */
+    uint32_t progress_interval_ms;
+    saleman_progress_fn progress; /* opcional */
+    void *user;
+} saleman_options;
+
+SALEMAN_API void saleman_default_options(saleman_options *options);
+
+/*
+ * tour recebe n indices (0 .. n-1, na ordem de entrada); length pode ser NULL.
+ * As coordenadas podem estar em qualquer escala, e length sai nas mesmas
+ * unidades, medido sobre as coordenadas originais.
+ */
+SALEMAN_API int saleman_solve_coords(const double *x, const double *y, uint32_t n, const saleman_options *options,
+                                     uint32_t *tour, double *length);
+
+SALEMAN_API int saleman_solve_matrix(const double *matrix, uint32_t n, const saleman_options *options,
+                                     uint32_t *tour, double *length);
+
+SALEMAN_API const char *saleman_last_error(void);
+SALEMAN_API int saleman_api_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SALEMAN_H */
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include "saleman.h"
+#include "solver.h"
+
+#define CAPI_DENSE_MATRIX_LIMIT 10000
+// Lado da grade inteira em que as coordenadas do chamador sao escaladas. Com
+// 2^24 os produtos da triangulacao ainda sao exatos em double.
+#define CAPI_COORD_GRID 16777216.0
+
+namespace {
+
+thread_local std::string lastError;
+
+int fail(const int code, const char *message)
+{
+    lastError = message;
+    return code;
+}
+
+// Copia so os campos que o chamador conhece: structs de versoes futuras
+// crescem no fim, e as antigas continuam aceitas.
+bool readOptions(const saleman_options *options, saleman_options &out)
+{
+    saleman_default_options(&out);
+    if (!options) return true;
+    if (options->struct_size < offsetof(saleman_options, progress_interval_ms)) return false;
+    std::memcpy(&out, options, std::min<size_t>(options->struct_size, sizeof(out)));
+    out.struct_size = sizeof(out);
+    return true;
+}
+
+// unit converte distancias do problema para as unidades do chamador no
+// callback de progresso e no comprimento devolvido.
+int solve(Problem &problem, const saleman_options *options, const double unit, uint32_t *tour, double *length)
+{
+    saleman_options opt;
+    if (!readOptions(options, opt)) return fail(SALEMAN_EINVAL, "saleman_options.struct_size too small.");
+    if (!tour) return fail(SALEMAN_EINVAL, "tour buffer is NULL.");
+    if (!(opt.time_budget > 0.0)) return fail(SALEMAN_EINVAL, "time_budget must be positive.");
+    if (opt.algorithm < SALEMAN_ANNEALING || opt.algorithm > SALEMAN_MULTILEVEL)
+        return fail(SALEMAN_EINVAL, "unknown algorithm.");
+    // particionado e multinivel partem do grafo de candidatos, que so existe
+    // com coordenadas
+    if ((opt.algorithm == SALEMAN_PARTITIONED || opt.algorithm == SALEMAN_MULTILEVEL) && problem.candidates.empty())
+        return fail(SALEMAN_EINVAL, "partitioned and multilevel need coordinates, not a matrix.");
+
+    static constexpr Algorithm algorithms[] = {Algorithm::Annealing, Algorithm::Genetic, Algorithm::LocalSearch,
+                                               Algorithm::Hybrid, Algorithm::Partitioned, Algorithm::Multilevel};
+    const auto start = std::chrono::steady_clock::now();
+    SolveParams params;
+    params.algorithm = algorithms[opt.algorithm];
+    params.deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double>(opt.time_budget));
+
+    // o callback so recebe a distancia; o tour nao e copiado a cada melhora
+    const auto interval = std::chrono::milliseconds(opt.progress_interval_ms);
+    auto lastReport = start - interval;
+    double pending = std::numeric_limits<double>::quiet_NaN();
+    bool cancel = false;
+    auto report = [&](const double best) {
+        const auto now = std::chrono::steady_clock::now();
+        lastReport = now;
+        pending = std::numeric_limits<double>::quiet_NaN();
+        if (opt.progress(best * unit, std::chrono::duration<double>(now - start).count(), opt.user) != 0) cancel = true;
+    };
+    SolverObserver observer;
+    if (opt.progress)
+    {
+        // devolver false ao solver encerra a busca com o melhor tour atual
+        observer.onImprovement = [&](const Path &best, uint64_t) {
+            pending = best.dist;
+            if (std::chrono::steady_clock::now() - lastReport >= interval) report(best.dist);
+            return !cancel;
+        };
+        params.observer = &observer;
+    }
+
+    RNG rng = opt.seed ? RNG(opt.seed) : RNG();
+    const Path best = solveTimed(problem, params, rng);
+    if (opt.progress && !std::isnan(pending) && !cancel) report(pending);
+
+    for (size_t i = 0; i < best.order.size(); ++i) tour[i] = problem.cities[best.order[i]].tag;
+    if (length) *length = best.dist * unit;
+    return SALEMAN_OK;
+}
+
+// Comprimento do tour fechado nas coordenadas originais, sem o arredondamento
+// da grade.
+double tourLength(const double *x, const double *y, const uint32_t *tour, const uint32_t n)
+{
+    double total = 0.0;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const uint32_t a = tour[i], b = tour[(i + 1) % n];
+        total += std::hypot(x[a] - x[b], y[a] - y[b]);
+    }
+    return total;
+}
+
+template <typename F>
+int guarded(F &&f)
+{
+    try
+    {
+        return f();
+    }
+    catch (const std::bad_alloc &)
+    {
+        return fail(SALEMAN_ENOMEM, "out of memory.");
+    }
+    catch (const std::exception &e)
+    {
+        return fail(SALEMAN_EINTERNAL, e.what());
+    }
+    catch (...)
+    {
+        return fail(SALEMAN_EINTERNAL, "unknown error.");
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void saleman_default_options(saleman_options *options)
+{
+    if (!options) return;
+    *options = saleman_options{};
+    options->struct_size = sizeof(saleman_options);
+    options->algorithm = SALEMAN_HYBRID;
+    options->time_budget = 1.0;
+    options->progress_interval_ms = 100;
+}
+
+int saleman_solve_coords(const double *x, const double *y, const uint32_t n, const saleman_options *options,
+                         uint32_t *tour, double *length)
+{
+    if (!x || !y) return fail(SALEMAN_EINVAL, "coordinate arrays are NULL.");
+    if (n < 5) return fail(SALEMAN_EINVAL, "need at least 5 cities.");
+    return guarded([&]() {
+        const double minX = *std::min_element(x, x + n), maxX = *std::max_element(x, x + n);
+        const double minY = *std::min_element(y, y + n), maxY = *std::max_element(y, y + n);
+        const double span = std::max(maxX - minX, maxY - minY);
+        if (!std::isfinite(span)) return fail(SALEMAN_EINVAL, "coordinates are not finite.");
+
+        // a escala independe da unidade do chamador: um quadrado unitario ocupa
+        // a grade inteira em vez de cair em dois pontos
+        const double scale = span > 0.0 ? CAPI_COORD_GRID / span : 1.0;
+        Problem problem;
+        problem.cities.resize(n);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            City &c = problem.cities[i];
+            c.x = static_cast<unsigned int>(std::lround((x[i] - minX) * scale));
+            c.y = static_cast<unsigned int>(std::lround((y[i] - minY) * scale));
+            c.tag = i;
+        }
+        initializeMap(problem.map, static_cast<unsigned int>(std::lround((maxX - minX) * scale)) + 1,
+                      static_cast<unsigned int>(std::lround((maxY - minY) * scale)) + 1);
+        prepareProblem(problem, CAPI_DENSE_MATRIX_LIMIT);
+        const int status = solve(problem, options, 1.0 / scale, tour, nullptr);
+        if (status == SALEMAN_OK && length) *length = tourLength(x, y, tour, n);
+        return status;
+    });
+}
+
+int saleman_solve_matrix(const double *matrix, const uint32_t n, const saleman_options *options, uint32_t *tour,
+                         double *length)
+{
+    if (!matrix) return fail(SALEMAN_EINVAL, "distance matrix is NULL.");
+    if (n < 5) return fail(SALEMAN_EINVAL, "need at least 5 cities.");
+    return guarded([&]() {
+        // sem coordenadas: nem Hilbert nem candidatos, so a matriz emprestada
+        Problem problem;
+        problem.cities.resize(n);
+        for (uint32_t i = 0; i < n; ++i) problem.cities[i].tag = i;
+        problem.externalMatrix = matrix;
+        return solve(problem, options, 1.0, tour, length);
+    });
+}
+
+const char *saleman_last_error(void) { return lastError.c_str(); }
+
+int saleman_api_version(void) { return SALEMAN_API_VERSION; }
+
+} // extern "C"
@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "annealing.h"
+#include "genetic.h"
+#include "solver.h"
+
+#define SCALING_DENSE_MATRIX_LIMIT 5000
+#define SCALING_SA_STEPS 20   // passos de temperatura por cadeia
+#define SCALING_ILS_KICKS 20  // perturbacoes por partida de ILS
+
+namespace {
+
+// Cargas de trabalho fixas (nada de prazo: escalabilidade mede trabalho por
+// tempo). Uma unidade e um lote de 256 tours avaliados (evaluate), uma
+// cadeia de SA com numero fixo de passos de temperatura (multistart) ou uma
+// partida de busca local iterada com numero fixo de perturbacoes (ils).
+enum class Workload { Evaluate, MultiStart, IteratedLocalSearch };
+
+const char *workloadName(const Workload w)
+{
+    switch (w)
+    {
+    case Workload::Evaluate: return "evaluate";
+    case Workload::MultiStart: return "multistart";
+    default: return "ils";
+    }
+}
+
+struct Options {
+    std::vector<size_t> threads;
+    std::vector<unsigned int> sizes{500, 2000};
+    std::vector<Workload> workloads{Workload::Evaluate, Workload::MultiStart, Workload::IteratedLocalSearch};
+    size_t units = 64;   // unidades por medicao forte; por thread na fraca
+    size_t reps = 3;     // repeticoes; vale a mediana
+    bool pin = true;
+    std::string out = "scaling.json";
+};
+
+std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+#endif
+    if (cpus.empty()) cpus.push_back(0);
+    return cpus;
+}
+
+// Fixa a thread que chama em uma CPU; devolve false se nao foi possivel.
+bool pinCurrentThread(const int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Estado de cada thread, montado fora do tempo medido.
+struct WorkerState {
+    RNG rng;
+    std::vector<Path> population;
+    AnnealingState annealing;
+    explicit WorkerState(const uint64_t seed) : rng(seed) {}
+};
+
+void prepareWorker(const Workload workload, const Problem &problem, WorkerState &ws)
+{
+    if (workload == Workload::Evaluate)
+    {
+        ws.population.resize(256);
+        initPopulation(ws.population, problem.numCities(), ws.rng);
+    }
+    else if (workload == Workload::MultiStart)
+    {
+        ws.annealing.problem = &problem;
+        ws.annealing.currentPath.order.resize(problem.numCities());
+        std::iota(ws.annealing.currentPath.order.begin(), ws.annealing.currentPath.order.end(), 0);
+    }
+}
+
+void runUnit(const Workload workload, const Problem &problem, WorkerState &ws)
+{
+    const size_t n = problem.numCities();
+    switch (workload)
+    {
+    case Workload::Evaluate:
+        evaluate(ws.population, problem);
+        break;
+    case Workload::MultiStart: {
+        // cadeia nova a partir de um tour aleatorio; sem parada por estagnacao
+        AnnealingState &state = ws.annealing;
+        state.params = defaultAnnealingParams(n);
+        state.params.stallLimit = std::numeric_limits<unsigned int>::max();
+        state.params.actualTemp = state.params.initialTemp;
+        state.iterations = state.currentIterations = state.stallCounter = 0;
+        std::shuffle(state.currentPath.order.begin(), state.currentPath.order.end(), ws.rng.eng);
+        state.currentPath.dist = routeLength(state.currentPath.order, problem);
+        state.bestPath = state.currentPath;
+        state.bestDist = state.currentPath.dist;
+        for (int step = 0; step < SCALING_SA_STEPS && runAnnealing(state, ws.rng); ++step) {
+        }
+        break;
+    }
+    default: {
+        Path path = greedyEdgeTour(problem);
+        localSearch(path, problem);
+        std::vector<CityId> touched;
+        for (int kick = 0; kick < SCALING_ILS_KICKS; ++kick)
+        {
+            Path trial = path;
+            doubleBridge(trial.order, ws.rng, touched);
+            localSearch(trial, problem, LocalSearchParams(), problem.candidates.empty() ? nullptr : &touched);
+            if (trial.dist < path.dist) path = std::move(trial);
+        }
+        break;
+    }
+    }
+}
+
+// Executa units unidades divididas estaticamente entre threads (fixadas em
+// CPUs distintas quando possivel) e devolve os segundos de parede. O relogio
+// comeca quando todas as threads estao prontas.
+double measure(const Workload workload, const Problem &problem, const size_t threads, const size_t units,
+               const std::vector<int> &cpus, const bool pin, bool &pinned)
+{
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> pinFailed{false};
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]() {
+            if (pin && !pinCurrentThread(cpus[t % cpus.size()])) pinFailed = true;
+            WorkerState ws(1000 + t);
+            prepareWorker(workload, problem, ws);
+            ++ready;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (size_t u = t; u < units; u += threads) runUnit(workload, problem, ws);
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &th : pool) th.join();
+    pinned = pin && !pinFailed;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T, typename F>
+std::vector<T> splitList(const std::string &s, F &&parse)
+{
+    std::vector<T> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) out.push_back(parse(item));
+    return out;
+}
+
+Workload parseWorkload(const std::string &s)
+{
+    for (const Workload w : {Workload::Evaluate, Workload::MultiStart, Workload::IteratedLocalSearch})
+        if (s == workloadName(w)) return w;
+    throw std::runtime_error("Unknown workload " + s + " (expected evaluate, multistart or ils).");
+}
+
+} // namespace
+
+// saleman_scaling [--threads 1,2,4] [--sizes 500,2000] [--workloads evaluate,multistart,ils]
+//                 [--units u] [--reps r] [--no-pin] [--out arquivo.json]
+// Escalabilidade forte (u unidades divididas entre T threads) e fraca (u
+// unidades por thread: o problema, em numero de tours avaliados, cadeias ou
+// partidas, cresce com T). Cada tamanho usa a mesma instancia nos dois
+// modos; speedup e eficiencia sao relativos a uma thread e o relatorio sai
+// em JSON.
+int main(int argc, char** argv)
+{
+    Options opt;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+                opt.threads = splitList<size_t>(argv[++i], [](const std::string& s) { return std::stoul(s); });
+            else if (std::strcmp(argv[i], "--sizes") == 0 && hasValue)
+                opt.sizes = splitList<unsigned int>(argv[++i], [](const std::string& s) { return static_cast<unsigned int>(std::stoul(s)); });
+            else if (std::strcmp(argv[i], "--workloads") == 0 && hasValue)
+                opt.workloads = splitList<Workload>(argv[++i], parseWorkload);
+            else if (std::strcmp(argv[i], "--units") == 0 && hasValue) opt.units = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--reps") == 0 && hasValue) opt.reps = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--no-pin") == 0) opt.pin = false;
+            else if (std::strcmp(argv[i], "--out") == 0 && hasValue) opt.out = argv[++i];
+            else throw std::runtime_error(std::string("unknown argument ") + argv[i] + ".");
+        }
+        const std::vector<int> cpus = allowedCpus();
+        if (opt.threads.empty())
+            for (size_t t = 1; t <= cpus.size(); t *= 2) opt.threads.push_back(t);
+        if (std::find(opt.threads.begin(), opt.threads.end(), size_t{1}) == opt.threads.end())
+            opt.threads.insert(opt.threads.begin(), 1); // referencia das razoes
+        std::sort(opt.threads.begin(), opt.threads.end());
+        if (opt.units == 0 || opt.reps == 0 || opt.threads.front() == 0)
+            throw std::runtime_error("--units, --reps and --threads must be positive.");
+
+        std::ofstream json(opt.out);
+        if (!json) throw std::runtime_error("cannot write " + opt.out + ".");
+        json << "{\n  \"cpus\": " << cpus.size() << ",\n  \"kernels\": \"" << isaName(kernels().isa)
+             << "\",\n  \"units\": " << opt.units << ",\n  \"reps\": " << opt.reps << ",\n  \"results\": [";
+        bool firstRow = true;
+
+        std::printf("cpus: %zu, kernels: %s\n", cpus.size(), isaName(kernels().isa));
+        std::printf("%-10s %-6s %8s %7s %10s %9s %10s %6s\n", "workload", "mode", "cities", "threads", "seconds",
+                    "speedup", "efficiency", "pinned");
+
+        auto instance = [](const unsigned int n) {
+            Problem p;
+            RNG rng(n);
+            initializeMap(p.map, 10000, 10000);
+            populateCities(p, rng, p.map, n);
+            prepareProblem(p, SCALING_DENSE_MATRIX_LIMIT);
+            return p;
+        };
+        auto median = [&](const Workload w, const Problem& p, const size_t threads, const size_t units, bool& pinned) {
+            std::vector<double> s;
+            for (size_t r = 0; r < opt.reps; ++r) s.push_back(measure(w, p, threads, units, cpus, opt.pin, pinned));
+            std::sort(s.begin(), s.end());
+            return s[s.size() / 2];
+        };
+
+        for (const Workload w : opt.workloads)
+        {
+            for (const unsigned int n : opt.sizes)
+            {
+                const Problem problem = instance(n);
+                double strongBase = 0.0, weakBase = 0.0;
+                for (const bool weak : {false, true})
+                {
+                    for (const size_t threads : opt.threads)
+                    {
+                        const size_t units = weak ? opt.units * threads : opt.units;
+                        bool pinned = false;
+                        const double secs = median(w, problem, threads, units, pinned);
+                        double& base = weak ? weakBase : strongBase;
+                        if (threads == 1) base = secs;
+                        // forte: t1 / tT; fraca: o trabalho cresce T vezes, entao T * t1 / tT
+                        const double speedup = (weak ? static_cast<double>(threads) : 1.0) * base / secs;
+                        const double efficiency = speedup / static_cast<double>(threads);
+                        std::printf("%-10s %-6s %8u %7zu %10.4f %9.2f %10.2f %6s\n", workloadName(w),
+                                    weak ? "weak" : "strong", n, threads, secs, speedup, efficiency,
+                                    pinned ? "yes" : "no");
+                        std::fflush(stdout);
+                        json << (firstRow ? "\n" : ",\n") << "    {\"workload\": \"" << workloadName(w)
+                             << "\", \"mode\": \"" << (weak ? "weak" : "strong") << "\", \"cities\": " << n
+                             << ", \"threads\": " << threads << ", \"units\": " << units << ", \"seconds\": " << secs
+                             << ", \"speedup\": " << speedup << ", \"efficiency\": " << efficiency
+                             << ", \"pinned\": " << (pinned ? "true" : "false") << "}";
+                        firstRow = false;
+                    }
+                }
+            }
+        }
+        json << "\n  ]\n}\n";
+        std::printf("wrote %s\n", opt.out.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_scaling: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
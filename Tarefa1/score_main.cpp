@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "instance_io.h"
+#include "map.h"
+
+#define SCORE_DENSE_MATRIX_LIMIT 5000 // acima disso, distancias sob demanda pelas coordenadas
+#define SCORE_BLOCK_BYTES (64u << 20) // tours lidos por bloco de saida
+#define SCORE_TASK_TOURS 256          // tours por tarefa de uma thread (um lote SIMD)
+
+namespace {
+
+// Arquivo inteiro mapeado so para leitura.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+    {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + ".");
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path + ".");
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        if (bytes == 0) return;
+        void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path + ".");
+        }
+        ::madvise(p, bytes, MADV_SEQUENTIAL);
+        base = static_cast<const unsigned char*>(p);
+    }
+
+    ~MappedFile()
+    {
+        if (base) ::munmap(const_cast<unsigned char*>(base), bytes);
+        if (fd >= 0) ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const unsigned char* data() const noexcept { return base; }
+    [[nodiscard]] size_t size() const noexcept { return bytes; }
+
+private:
+    int fd = -1;
+    const unsigned char* base = nullptr;
+    size_t bytes = 0;
+};
+
+// Tours do lote se referem aos nos pela ordem original; o problema e
+// reordenado por tag para indice e tag coincidirem.
+void orderByTag(Problem& problem)
+{
+    const size_t n = problem.numCities();
+    std::vector<City> byTag(n);
+    std::vector<bool> seen(n, false);
+    for (const City& c : problem.cities)
+    {
+        if (c.tag >= n || seen[c.tag]) throw std::runtime_error("instance tags are not a permutation.");
+        seen[c.tag] = true;
+        byTag[c.tag] = c;
+    }
+    problem.cities = std::move(byTag);
+}
+
+class Scorer
+{
+public:
+    Scorer(const Problem& problem, const bool dense) : problem(problem), n(problem.numCities())
+    {
+        if (dense) distM = problem.denseDistances();
+        if (dense && !problem.intDistanceMatrix.empty()) intM = problem.intDistanceMatrix.data();
+    }
+
+    // Pontua tours[0..count) em out (NaN nos invalidos). seen e o bitset da
+    // thread, com n bits zerados na entrada e na saida.
+    void score(const uint32_t* tours, const size_t count, double* out, std::vector<uint64_t>& seen,
+               size_t& invalid) const
+    {
+        const uint32_t* valid[SCORE_TASK_TOURS];
+        size_t slot[SCORE_TASK_TOURS];
+        double lengths[SCORE_TASK_TOURS];
+        for (size_t begin = 0; begin < count; begin += SCORE_TASK_TOURS)
+        {
+            const size_t end = std::min(count, begin + SCORE_TASK_TOURS);
+            size_t k = 0;
+            for (size_t t = begin; t < end; ++t)
+            {
+                const uint32_t* tour = tours + t * n;
+                if (isPermutation(tour, seen))
+                {
+                    valid[k] = tour;
+                    slot[k++] = t;
+                }
+                else
+                {
+                    out[t] = std::numeric_limits<double>::quiet_NaN();
+                    ++invalid;
+                }
+            }
+            // fora da faixa de batchPays o laco escalar por tour e mais rapido
+            if (intM && batchPays(n))
+            {
+                // metricas TSPLIB: somas exatas em int64, convertidas so no fim
+                int64_t intLengths[SCORE_TASK_TOURS];
+                kernels().routeLengthBatchInt(valid, k, n, intM, intLengths);
+                for (size_t i = 0; i < k; ++i) lengths[i] = static_cast<double>(intLengths[i]);
+            }
+            else if (distM && batchPays(n))
+            {
+                routeLengthBatch(valid, k, n, distM, lengths);
+            }
+            else
+            {
+                for (size_t i = 0; i < k; ++i) lengths[i] = length(valid[i]);
+            }
+            for (size_t i = 0; i < k; ++i) out[slot[i]] = lengths[i];
+        }
+    }
+
+private:
+    bool isPermutation(const uint32_t* tour, std::vector<uint64_t>& seen) const
+    {
+        size_t i = 0;
+        bool ok = true;
+        for (; i < n; ++i)
+        {
+            const uint32_t c = tour[i];
+            if (c >= n || (seen[c >> 6] >> (c & 63) & 1u))
+            {
+                ok = false;
+                break;
+            }
+            seen[c >> 6] |= uint64_t{1} << (c & 63);
+        }
+        // so este tour marcou bits: zerar as palavras tocadas limpa o bitset
+        for (size_t j = 0; j < i; ++j) seen[tour[j] >> 6] = 0;
+        return ok;
+    }
+
+    double length(const uint32_t* tour) const
+    {
+        if (intM) return static_cast<double>(kernels().routeLengthInt(tour, n, intM));
+        if (distM) return kernels().routeLength(tour, n, distM);
+        double acc = 0.0;
+        for (size_t i = 0; i + 1 < n; ++i) acc += problem.cityDistance(tour[i], tour[i + 1]);
+        return acc + problem.cityDistance(tour[n - 1], tour[0]);
+    }
+
+    const Problem& problem;
+    const size_t n;
+    const double* distM = nullptr;
+    const int32_t* intM = nullptr;
+};
+
+} // namespace
+
+// saleman_score [--threads t] [--dense-limit n] [--binary] [--out arquivo] instancia lote.bin
+// Pontua em massa um lote de tours (TourBatchHeader, instance_io.h) contra
+// uma instancia binaria ou TSPLIB. O lote e mapeado e lido em blocos: cada
+// bloco e dividido entre as threads, que validam os tours com um bitset e os
+// pontuam pela matriz densa (ou pelas coordenadas, acima de --dense-limit
+// cidades), em lotes SIMD na faixa de tamanhos em que eles medem mais rapido
+// (batchPays, kernels.h), e os comprimentos saem em ordem, um por linha
+// ("invalid" para tours que nao sao permutacao) ou, com --binary, como
+// doubles com NaN nos invalidos.
+int main(int argc, char** argv)
+{
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t denseLimit = SCORE_DENSE_MATRIX_LIMIT;
+    bool binary = false;
+    std::string outPath;
+    std::vector<std::string> files;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--threads") == 0 && hasValue) threads = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--dense-limit") == 0 && hasValue) denseLimit = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--binary") == 0) binary = true;
+            else if (std::strcmp(argv[i], "--out") == 0 && hasValue) outPath = argv[++i];
+            else files.push_back(argv[i]);
+        }
+        if (files.size() != 2) throw std::runtime_error("usage: saleman_score [options] instance tours.bin");
+        if (threads == 0) throw std::runtime_error("--threads must be positive.");
+
+        Problem problem = readInstance(files[0]);
+        orderByTag(problem);
+        const size_t n = problem.numCities();
+        if (n < 2) throw std::runtime_error("instance needs at least 2 cities.");
+        const bool dense = n <= denseLimit;
+        if (dense) buildDenseMatrix(problem);
+
+        const MappedFile batch(files[1]);
+        TourBatchHeader header{};
+        if (batch.size() < sizeof(header)) throw std::runtime_error("tour batch: file too short.");
+        std::memcpy(&header, batch.data(), sizeof(header));
+        if (std::memcmp(header.magic, tourBatchMagic, sizeof(header.magic)) != 0)
+            throw std::runtime_error("tour batch: bad magic.");
+        if (header.version != tourBatchVersion) throw std::runtime_error("tour batch: unsupported version.");
+        if (header.numCities != n) throw std::runtime_error("tour batch: city count does not match the instance.");
+        if ((batch.size() - sizeof(header)) / (n * sizeof(uint32_t)) < header.count)
+            throw std::runtime_error("tour batch: truncated.");
+        // o cabecalho tem 32 bytes, entao os uint32 ficam alinhados
+        const uint32_t* tours = reinterpret_cast<const uint32_t*>(batch.data() + sizeof(header));
+
+        FILE* out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), binary ? "wb" : "w");
+        if (!out) throw std::runtime_error("cannot write " + outPath + ".");
+
+        const Scorer scorer(problem, dense);
+        const size_t blockTours = std::max<size_t>(SCORE_TASK_TOURS, SCORE_BLOCK_BYTES / (n * sizeof(uint32_t)));
+        std::vector<double> lengths(std::min<uint64_t>(blockTours, header.count));
+        std::vector<std::vector<uint64_t>> seen(threads, std::vector<uint64_t>((n + 63) / 64, 0));
+        std::vector<size_t> invalid(threads, 0);
+        std::string text;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (uint64_t first = 0; first < header.count; first += blockTours)
+        {
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(blockTours, header.count - first));
+            const uint32_t* block = tours + first * n;
+            const size_t tasks = (count + SCORE_TASK_TOURS - 1) / SCORE_TASK_TOURS;
+            std::atomic<size_t> next{0};
+            auto worker = [&](const size_t t) {
+                for (size_t task = next++; task < tasks; task = next++)
+                {
+                    const size_t begin = task * SCORE_TASK_TOURS;
+                    scorer.score(block + begin * n, std::min<size_t>(SCORE_TASK_TOURS, count - begin),
+                                 lengths.data() + begin, seen[t], invalid[t]);
+                }
+            };
+            std::vector<std::thread> pool;
+            for (size_t t = 1; t < std::min(threads, tasks); ++t) pool.emplace_back(worker, t);
+            worker(0);
+            for (auto& th : pool) th.join();
+
+            if (binary)
+            {
+                std::fwrite(lengths.data(), sizeof(double), count, out);
+                continue;
+            }
+            text.clear();
+            char buf[32];
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double d = lengths[i];
+                const int len = std::isnan(d) ? std::snprintf(buf, sizeof(buf), "invalid\n")
+                                : integralMetric(problem.metric) ? std::snprintf(buf, sizeof(buf), "%.0f\n", d)
+                                                                 : std::snprintf(buf, sizeof(buf), "%.17g\n", d);
+                text.append(buf, static_cast<size_t>(len));
+            }
+            std::fwrite(text.data(), 1, text.size(), out);
+        }
+        if (std::fflush(out) != 0 || std::ferror(out)) throw std::runtime_error("error writing the lengths.");
+        if (out != stdout) std::fclose(out);
+
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t bad = 0;
+        for (const size_t b : invalid) bad += b;
+        const double gb = static_cast<double>(header.count) * static_cast<double>(n * sizeof(uint32_t)) / 1e9;
+        std::fprintf(stderr, "%llu tours of %zu cities (%zu invalid) in %.3f s: %.0f tours/s, %.2f GB/s, %s, %s\n",
+                     static_cast<unsigned long long>(header.count), n, bad, secs,
+                     static_cast<double>(header.count) / secs, gb / secs, dense ? "dense matrix" : "coordinates",
+                     isaName(kernels().isa));
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_score: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
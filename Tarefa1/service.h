@@ -0,0 +1,450 @@
+#ifndef SALEMAN_SERVICE_H
+#define SALEMAN_SERVICE_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "instance_io.h"
+#include "map.h"
+#include "solver.h"
+
+// Servico de resolucao local sobre um socket Unix. Protocolo em texto, uma
+// requisicao por linha:
+//
+//   solve <sa|ga|ls|hy|pt|ml> <segundos> [priority=<p>] [deadline=<s>] [seed=<s>] file <caminho>
+//   solve <sa|ga|ls|hy|pt|ml> <segundos> [...] cities <n>      seguida de n linhas "<x> <y>"
+//   stats
+//
+// Respostas: "queued <id>", "improved <id> <s> <dist> <tags...>" (tags das
+// cidades, no mesmo numero de no do arquivo ou na ordem enviada), "done <id>
+// <dist>", "error <id|-> <mensagem>" e "stats ...". Os jobs vao para uma fila
+// por prioridade (maior primeiro) e prazo (mais cedo primeiro); deadline e
+// contado a partir do envio e limita tambem o tempo de espera na fila.
+
+struct ServiceParams {
+    std::string socketPath;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t cacheCapacity = 8;  // instancias preparadas mantidas em memoria
+    size_t denseLimit = 5000;  // acima disso so o grafo de candidatos
+    std::chrono::milliseconds streamInterval{50}; // intervalo minimo entre "improved" do mesmo job
+};
+
+// Conexao de um cliente. Workers e a thread de leitura escrevem nela;
+// closed tambem serve de cancelamento dos jobs pendentes do cliente.
+class ServiceClient {
+public:
+    explicit ServiceClient(const int fd) : fd(fd) {}
+    ServiceClient(const ServiceClient &) = delete;
+    ServiceClient &operator=(const ServiceClient &) = delete;
+    ~ServiceClient() { ::close(fd); }
+
+    void send(const std::string &line) {
+        std::lock_guard<std::mutex> lk(mutex);
+        if (closed) return;
+        size_t sent = 0;
+        while (sent < line.size()) {
+            const ssize_t w = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) {
+                closed = true;
+                return;
+            }
+            sent += static_cast<size_t>(w);
+        }
+    }
+
+    // Linha seguinte sem o '\n'; false no fim da conexao.
+    bool readLine(std::string &line) {
+        while (true) {
+            const size_t eol = buffer.find('\n');
+            if (eol != std::string::npos) {
+                line = buffer.substr(0, eol);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                buffer.erase(0, eol + 1);
+                return true;
+            }
+            char chunk[4096];
+            const ssize_t r = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (r <= 0) return false;
+            buffer.append(chunk, static_cast<size_t>(r));
+        }
+    }
+
+    void shutdown() {
+        closed = true;
+        ::shutdown(fd, SHUT_RDWR);
+    }
+
+    std::atomic<bool> closed{false};
+
+private:
+    const int fd;
+    std::mutex mutex;
+    std::string buffer;
+};
+
+struct ServiceJob {
+    uint64_t id = 0;
+    int priority = 0;
+    std::chrono::steady_clock::time_point submitted, deadline;
+    double budget = 0.0;
+    Algorithm algorithm = Algorithm::LocalSearch;
+    uint64_t seed = 0;
+    std::string file;          // instancia em arquivo TSPLIB ...
+    std::vector<City> cities;  // ... ou enviada na requisicao
+    std::shared_ptr<ServiceClient> client;
+};
+
+// Instancias preparadas (renumeracao, candidatos e matriz), chaveadas pelo
+// caminho do arquivo ou pelas coordenadas enviadas, com descarte LRU.
+class InstanceCache {
+public:
+    InstanceCache(const size_t capacity, const size_t denseLimit) : capacity(capacity), denseLimit(denseLimit) {}
+
+    std::shared_ptr<const Problem> get(const ServiceJob &job) {
+        const std::string key = job.file.empty() ? citiesKey(job.cities) : "file:" + job.file;
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            const auto it = entries.find(key);
+            if (it != entries.end()) {
+                ++hits;
+                lru.splice(lru.begin(), lru, it->second.second);
+                return it->second.first;
+            }
+        }
+        // montada fora da trava; dois jobs simultaneos da mesma instancia
+        // podem preparar copias iguais, e a segunda substitui a primeira
+        auto problem = std::make_shared<Problem>();
+        if (job.file.empty()) {
+            problem->cities = job.cities;
+        } else {
+            *problem = readTSPLIB(job.file);
+        }
+        prepareProblem(*problem, denseLimit);
+
+        std::lock_guard<std::mutex> lk(mutex);
+        ++misses;
+        const auto it = entries.find(key);
+        if (it != entries.end()) {
+            it->second.first = problem;
+            lru.splice(lru.begin(), lru, it->second.second);
+        } else {
+            lru.push_front(key);
+            entries.emplace(key, std::make_pair(problem, lru.begin()));
+        }
+        while (entries.size() > capacity) {
+            entries.erase(lru.back());
+            lru.pop_back();
+        }
+        return problem;
+    }
+
+    [[nodiscard]] std::string stats() const {
+        std::lock_guard<std::mutex> lk(mutex);
+        return "cached=" + std::to_string(entries.size()) + " hits=" + std::to_string(hits) +
+               " misses=" + std::to_string(misses);
+    }
+
+private:
+    const size_t capacity, denseLimit;
+    mutable std::mutex mutex;
+    std::list<std::string> lru;
+    std::map<std::string, std::pair<std::shared_ptr<const Problem>, std::list<std::string>::iterator>> entries;
+    size_t hits = 0, misses = 0;
+
+    static std::string citiesKey(const std::vector<City> &cities) {
+        uint64_t h = 1469598103934665603ull; // FNV-1a
+        for (const City &c : cities) {
+            for (const uint64_t v : {static_cast<uint64_t>(c.x), static_cast<uint64_t>(c.y)}) {
+                h ^= v;
+                h *= 1099511628211ull;
+            }
+        }
+        return "cities:" + std::to_string(cities.size()) + ":" + std::to_string(h);
+    }
+};
+
+class SolveService {
+public:
+    explicit SolveService(ServiceParams params)
+        : params(std::move(params)), cache(this->params.cacheCapacity, this->params.denseLimit) {
+        if (this->params.socketPath.size() >= sizeof(sockaddr_un::sun_path))
+            throw std::runtime_error("SolveService: socket path too long.");
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) throw std::runtime_error("SolveService: cannot create socket.");
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, this->params.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        ::unlink(addr.sun_path);
+        if (::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(listenFd, 16) != 0) {
+            ::close(listenFd);
+            throw std::runtime_error("SolveService: cannot listen on " + this->params.socketPath + ".");
+        }
+        // pool aquecido: as threads existem antes do primeiro job
+        for (size_t w = 0; w < this->params.workers; ++w) workers.emplace_back([this]() { work(); });
+    }
+
+    SolveService(const SolveService &) = delete;
+    SolveService &operator=(const SolveService &) = delete;
+
+    ~SolveService() {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            stopping = true;
+            for (const auto &client : clients) client->shutdown();
+        }
+        cv.notify_all();
+        for (auto &[client, t] : readers) t.join();
+        for (auto &t : workers) t.join();
+        ::close(listenFd);
+        ::unlink(params.socketPath.c_str());
+    }
+
+    // Aceita conexoes ate stop ficar verdadeiro; cada cliente ganha uma
+    // thread de leitura.
+    void run(const std::atomic<bool> &stop) {
+        while (!stop) {
+            pollfd p{listenFd, POLLIN, 0};
+            const int ready = ::poll(&p, 1, 200);
+            reapReaders();
+            if (ready <= 0) continue;
+            const int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0) continue;
+            auto client = std::make_shared<ServiceClient>(fd);
+            std::lock_guard<std::mutex> lk(mutex);
+            clients.push_back(client);
+            readers.emplace(client.get(), std::thread([this, client]() { serve(client); }));
+        }
+    }
+
+private:
+    struct Later {
+        // topo da fila: maior prioridade, depois prazo mais cedo, depois ordem de chegada
+        bool operator()(const ServiceJob &a, const ServiceJob &b) const {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            if (a.deadline != b.deadline) return a.deadline > b.deadline;
+            return a.id > b.id;
+        }
+    };
+
+    const ServiceParams params;
+    InstanceCache cache;
+    int listenFd = -1;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::priority_queue<ServiceJob, std::vector<ServiceJob>, Later> queue;
+    std::vector<std::shared_ptr<ServiceClient>> clients;
+    std::map<const ServiceClient *, std::thread> readers;
+    std::vector<const ServiceClient *> finished; // leitores encerrados, ainda por juntar
+    std::vector<std::thread> workers;
+    bool stopping = false;
+    uint64_t nextId = 1;
+    size_t running = 0, completed = 0, expired = 0, cancelled = 0, failed = 0;
+
+    enum class Outcome { Done, Expired, Cancelled, Failed };
+
+    void reapReaders() {
+        std::vector<std::thread> done;
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            for (const ServiceClient *c : finished) {
+                const auto it = readers.find(c);
+                done.push_back(std::move(it->second));
+                readers.erase(it);
+            }
+            finished.clear();
+        }
+        for (auto &t : done) t.join();
+    }
+
+    void serve(const std::shared_ptr<ServiceClient> &client) {
+        std::string line;
+        while (client->readLine(line)) {
+            std::istringstream in(line);
+            std::string command;
+            if (!(in >> command)) continue;
+            if (command == "stats") {
+                client->send(stats());
+            } else if (command == "solve") {
+                try {
+                    submit(parseJob(in, *client, client));
+                } catch (const std::exception &e) {
+                    client->send(std::string("error - ") + e.what() + "\n");
+                }
+            } else {
+                client->send("error - unknown command " + command + "\n");
+            }
+        }
+        client->closed = true;
+        std::lock_guard<std::mutex> lk(mutex);
+        clients.erase(std::find(clients.begin(), clients.end(), client));
+        finished.push_back(client.get());
+    }
+
+    static ServiceJob parseJob(std::istringstream &in, ServiceClient &reader, const std::shared_ptr<ServiceClient> &client) {
+        ServiceJob job;
+        job.client = client;
+        job.submitted = std::chrono::steady_clock::now();
+        job.deadline = std::chrono::steady_clock::time_point::max();
+        job.seed = static_cast<uint64_t>(job.submitted.time_since_epoch().count());
+        std::string algorithm, token;
+        if (!(in >> algorithm >> job.budget) || !(job.budget > 0.0))
+            throw std::runtime_error("expected: solve <sa|ga|ls|hy|pt|ml> <seconds> ...");
+        job.algorithm = parseAlgorithm(algorithm);
+        while (in >> token) {
+            const size_t eq = token.find('=');
+            if (token == "file") {
+                std::getline(in >> std::ws, job.file);
+                if (job.file.empty()) throw std::runtime_error("missing instance path.");
+                return job;
+            }
+            if (token == "cities") {
+                size_t n = 0;
+                if (!(in >> n) || n < 5) throw std::runtime_error("need at least 5 cities.");
+                job.cities.resize(n);
+                std::string row;
+                for (size_t i = 0; i < n; ++i) {
+                    if (!reader.readLine(row)) throw std::runtime_error("truncated city list.");
+                    std::istringstream rs(row);
+                    if (!(rs >> job.cities[i].x >> job.cities[i].y)) throw std::runtime_error("bad city line: " + row);
+                    job.cities[i].tag = static_cast<CityId>(i);
+                }
+                return job;
+            }
+            if (eq == std::string::npos) throw std::runtime_error("unexpected token " + token + ".");
+            const std::string key = token.substr(0, eq), value = token.substr(eq + 1);
+            if (key == "priority") {
+                job.priority = std::stoi(value);
+            } else if (key == "deadline") {
+                job.deadline = job.submitted + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                   std::chrono::duration<double>(std::stod(value)));
+            } else if (key == "seed") {
+                job.seed = std::stoull(value);
+            } else {
+                throw std::runtime_error("unknown option " + key + ".");
+            }
+        }
+        throw std::runtime_error("expected 'file <path>' or 'cities <n>'.");
+    }
+
+    // O envio pode bloquear num cliente que nao le o socket, entao acontece
+    // fora do mutex do servico. "queued" sai antes de o job entrar na fila
+    // para nenhum "improved" do mesmo id chegar na frente.
+    void submit(ServiceJob job) {
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            job.id = nextId++;
+        }
+        job.client->send("queued " + std::to_string(job.id) + "\n");
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            queue.push(std::move(job));
+        }
+        cv.notify_one();
+    }
+
+    [[nodiscard]] std::string stats() {
+        std::lock_guard<std::mutex> lk(mutex);
+        return "stats queued=" + std::to_string(queue.size()) + " running=" + std::to_string(running) +
+               " completed=" + std::to_string(completed) + " expired=" + std::to_string(expired) +
+               " cancelled=" + std::to_string(cancelled) + " failed=" + std::to_string(failed) + " workers=" + std::to_string(workers.size()) + " " +
+               cache.stats() + "\n";
+    }
+
+    void work() {
+        while (true) {
+            ServiceJob job;
+            {
+                std::unique_lock<std::mutex> lk(mutex);
+                cv.wait(lk, [this]() { return stopping || !queue.empty(); });
+                if (stopping) return;
+                job = queue.top();
+                queue.pop();
+                ++running;
+            }
+            const Outcome outcome = execute(job);
+            std::lock_guard<std::mutex> lk(mutex);
+            --running;
+            switch (outcome) {
+            case Outcome::Done: ++completed; break;
+            case Outcome::Expired: ++expired; break;
+            case Outcome::Cancelled: ++cancelled; break;
+            default: ++failed;
+            }
+        }
+    }
+
+    // Resolve um job ate o menor entre orcamento e prazo, enviando os
+    // melhores tours no maximo a cada streamInterval (o ultimo sempre).
+    Outcome execute(const ServiceJob &job) {
+        const std::string id = std::to_string(job.id);
+        ServiceClient &client = *job.client;
+        const auto start = std::chrono::steady_clock::now();
+        if (client.closed) return Outcome::Cancelled;
+        if (start >= job.deadline) {
+            client.send("error " + id + " deadline expired in queue\n");
+            return Outcome::Expired;
+        }
+        try {
+            const std::shared_ptr<const Problem> problem = cache.get(job);
+            SolveParams solve;
+            solve.algorithm = job.algorithm;
+            solve.deadline = std::min(job.deadline, std::chrono::steady_clock::now() +
+                                                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                            std::chrono::duration<double>(job.budget)));
+            solve.cancel = &client.closed;
+
+            Path pending;
+            auto lastSent = start - params.streamInterval;
+            auto flush = [&]() {
+                std::ostringstream out;
+                out << "improved " << id << ' '
+                    << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << ' '
+                    << pending.dist;
+                for (const CityId c : pending.order) out << ' ' << problem->cities[c].tag;
+                out << '\n';
+                client.send(out.str());
+                lastSent = std::chrono::steady_clock::now();
+                pending.order.clear();
+            };
+            SolverObserver observer;
+            observer.onImprovement = [&](const Path &improved, uint64_t) {
+                pending = improved;
+                if (std::chrono::steady_clock::now() - lastSent >= params.streamInterval) flush();
+                return true;
+            };
+            solve.observer = &observer;
+            RNG rng(job.seed);
+            const Path best = solveTimed(*problem, solve, rng);
+            const bool cancelled = client.closed;
+            if (!pending.order.empty()) flush();
+            std::ostringstream done;
+            done << "done " << id << ' ' << best.dist << '\n';
+            client.send(done.str());
+            return cancelled ? Outcome::Cancelled : Outcome::Done;
+        } catch (const std::exception &e) {
+            client.send("error " + id + " " + e.what() + "\n");
+            return Outcome::Failed;
+        }
+    }
+};
+
+#endif //SALEMAN_SERVICE_H
@@ -0,0 +1,44 @@
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "service.h"
+
+#define SERVICE_SOCKET "/tmp/saleman.sock"
+
+namespace {
+
+std::atomic<bool> stopRequested{false};
+
+void requestStop(int) { stopRequested = true; }
+
+} // namespace
+
+// saleman_service [socket] [workers]   servico de resolucao em segundo plano;
+// encerra com SIGINT ou SIGTERM
+int main(int argc, char** argv)
+{
+    ServiceParams params;
+    params.socketPath = argc >= 2 ? argv[1] : SERVICE_SOCKET;
+    try
+    {
+        if (argc >= 3) params.workers = std::stoul(argv[2]);
+        if (params.workers == 0) throw std::runtime_error("Need at least one worker.");
+
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+
+        SolveService service(params);
+        std::fprintf(stderr, "saleman_service: listening on %s with %zu workers (kernels: %s)\n",
+                     params.socketPath.c_str(), params.workers, isaName(kernels().isa));
+        service.run(stopRequested);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_service: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
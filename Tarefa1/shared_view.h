@@ -0,0 +1,302 @@
+#ifndef SALEMAN_SHARED_VIEW_H
+#define SALEMAN_SHARED_VIEW_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "map.h"
+
+// Estado dos solvers publicado em memoria compartilhada POSIX para um
+// visualizador em outro processo. O segmento tem tres canais (instancia, SA e
+// GA), cada um com dois buffers protegidos por seqlock: quem publica escreve
+// no buffer que nao esta na frente e so entao o troca, sem travas e sem
+// esperar leitores. O leitor copia o buffer da frente e confere que a
+// sequencia nao mudou; so um buffer sobrescrito duas vezes durante a copia o
+// obriga a tentar de novo. O visualizador pode entrar e sair a qualquer hora.
+
+inline constexpr char sharedViewMagic[8] = {'S', 'L', 'M', 'N', 'V', 'I', 'E', 'W'};
+inline constexpr uint32_t sharedViewVersion = 1;
+
+enum class SharedChannel : uint32_t { Instance = 0, Annealing = 1, Genetic = 2 };
+
+struct SharedCity {
+    uint32_t x, y, tag;
+};
+
+// Contadores de um solver: step e iteracoes no SA e geracao no GA, stall so
+// no GA e temperature so no SA.
+struct SharedSolverStats {
+    uint64_t step = 0;
+    uint64_t stall = 0;
+    double best = 0.0;
+    double current = 0.0;
+    double temperature = 0.0;
+    uint32_t numCities = 0;
+    uint32_t finished = 0;
+};
+
+struct SharedInstanceStats {
+    uint32_t numCities = 0;
+    uint32_t reserved = 0;
+    double lowerBound = 0.0;
+};
+
+struct SharedViewHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t capacity; // cidades por buffer
+    int64_t pid;
+    char isa[16]; // kernels do processo do solver, para o HUD
+    std::atomic<uint64_t> heartbeat; // microssegundos de steady_clock do solver
+};
+
+struct alignas(64) SharedSlot {
+    std::atomic<uint64_t> seq; // impar durante a escrita
+};
+
+struct alignas(64) SharedChannelHeader {
+    std::atomic<uint32_t> front;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics");
+
+// Layout e acesso ao segmento, comum a quem escreve e a quem le.
+class SharedViewSegment {
+public:
+    SharedViewSegment(const SharedViewSegment &) = delete;
+    SharedViewSegment &operator=(const SharedViewSegment &) = delete;
+
+    ~SharedViewSegment() {
+        if (base) ::munmap(base, bytes);
+    }
+
+    [[nodiscard]] uint32_t capacity() const noexcept { return header()->capacity; }
+
+protected:
+    uint8_t *base = nullptr;
+    size_t bytes = 0;
+
+    SharedViewSegment() = default;
+
+    // Tamanho do payload de cada canal: estatisticas seguidas das cidades
+    // (instancia) ou dos tours best e current (solvers).
+    static size_t payloadSize(const SharedChannel channel, const size_t capacity) noexcept {
+        const size_t size = channel == SharedChannel::Instance
+                                ? sizeof(SharedInstanceStats) + capacity * sizeof(SharedCity)
+                                : sizeof(SharedSolverStats) + 2 * capacity * sizeof(CityId);
+        return (size + 63) & ~size_t{63};
+    }
+    static size_t slotSize(const SharedChannel channel, const size_t capacity) noexcept {
+        return sizeof(SharedSlot) + payloadSize(channel, capacity);
+    }
+    static size_t channelSize(const SharedChannel channel, const size_t capacity) noexcept {
+        return sizeof(SharedChannelHeader) + 2 * slotSize(channel, capacity);
+    }
+    static size_t headerSize() noexcept { return (sizeof(SharedViewHeader) + 63) & ~size_t{63}; }
+    static size_t segmentSize(const size_t capacity) noexcept {
+        return headerSize() + channelSize(SharedChannel::Instance, capacity) +
+               channelSize(SharedChannel::Annealing, capacity) + channelSize(SharedChannel::Genetic, capacity);
+    }
+
+    [[nodiscard]] SharedViewHeader *header() const noexcept { return reinterpret_cast<SharedViewHeader *>(base); }
+
+    [[nodiscard]] uint8_t *channelBase(const SharedChannel channel) const noexcept {
+        const size_t cap = header()->capacity;
+        size_t offset = headerSize();
+        for (uint32_t c = 0; c < static_cast<uint32_t>(channel); ++c) offset += channelSize(static_cast<SharedChannel>(c), cap);
+        return base + offset;
+    }
+    [[nodiscard]] SharedChannelHeader *channelHeader(const SharedChannel channel) const noexcept {
+        return reinterpret_cast<SharedChannelHeader *>(channelBase(channel));
+    }
+    [[nodiscard]] SharedSlot *slot(const SharedChannel channel, const uint32_t index) const noexcept {
+        return reinterpret_cast<SharedSlot *>(channelBase(channel) + sizeof(SharedChannelHeader) +
+                                              index * slotSize(channel, header()->capacity));
+    }
+    [[nodiscard]] static uint8_t *payload(SharedSlot *s) noexcept {
+        return reinterpret_cast<uint8_t *>(s) + sizeof(SharedSlot);
+    }
+};
+
+// Lado do solver: cria o segmento e publica. Cada canal deve ter um unico
+// escritor (a thread do respectivo solver).
+class SharedViewWriter : public SharedViewSegment {
+public:
+    SharedViewWriter(std::string name, const uint32_t capacity) : name(std::move(name)) {
+        ::shm_unlink(this->name.c_str()); // segmento de uma execucao anterior que nao terminou bem
+        const int fd = ::shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) throw std::runtime_error("Cannot create shared memory " + this->name + ".");
+        bytes = segmentSize(capacity);
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            ::shm_unlink(this->name.c_str());
+            throw std::runtime_error("Cannot size shared memory " + this->name + ".");
+        }
+        void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            ::shm_unlink(this->name.c_str());
+            throw std::runtime_error("Cannot map shared memory " + this->name + ".");
+        }
+        base = static_cast<uint8_t *>(p);
+
+        // ftruncate zera o segmento: seq = 0 em todos os buffers, front = 0
+        SharedViewHeader *h = header();
+        h->version = sharedViewVersion;
+        h->capacity = capacity;
+        h->pid = static_cast<int64_t>(::getpid());
+        std::strncpy(h->isa, isaName(kernels().isa), sizeof(h->isa) - 1);
+        heartbeat();
+        // magic por ultimo: o leitor so confia no segmento depois dele
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(h->magic, sharedViewMagic, sizeof(h->magic));
+    }
+
+    ~SharedViewWriter() { ::shm_unlink(name.c_str()); }
+
+    void heartbeat() noexcept {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        header()->heartbeat.store(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()),
+            std::memory_order_release);
+    }
+
+    void publishInstance(const std::vector<City> &cities, const double lowerBound) {
+        if (cities.size() > capacity()) throw std::runtime_error("SharedView: instance larger than the segment.");
+        publish(SharedChannel::Instance, [&](uint8_t *p) {
+            SharedInstanceStats stats;
+            stats.numCities = static_cast<uint32_t>(cities.size());
+            stats.lowerBound = lowerBound;
+            std::memcpy(p, &stats, sizeof(stats));
+            auto *out = reinterpret_cast<SharedCity *>(p + sizeof(stats));
+            for (size_t i = 0; i < cities.size(); ++i) out[i] = {cities[i].x, cities[i].y, cities[i].tag};
+        });
+    }
+
+    // Tours vazios ou de tamanho diferente de stats.numCities nao sao copiados.
+    void publishSolver(const SharedChannel channel, const SharedSolverStats &stats, const std::vector<CityId> &best,
+                       const std::vector<CityId> &current) {
+        if (stats.numCities > capacity()) throw std::runtime_error("SharedView: tour larger than the segment.");
+        publish(channel, [&](uint8_t *p) {
+            std::memcpy(p, &stats, sizeof(stats));
+            auto *tours = reinterpret_cast<CityId *>(p + sizeof(stats));
+            if (best.size() == stats.numCities) std::memcpy(tours, best.data(), best.size() * sizeof(CityId));
+            if (current.size() == stats.numCities)
+                std::memcpy(tours + capacity(), current.data(), current.size() * sizeof(CityId));
+        });
+    }
+
+private:
+    std::string name;
+
+    template <typename Fill>
+    void publish(const SharedChannel channel, Fill fill) {
+        SharedChannelHeader *ch = channelHeader(channel);
+        const uint32_t back = ch->front.load(std::memory_order_relaxed) ^ 1u;
+        SharedSlot *s = slot(channel, back);
+        const uint64_t seq = s->seq.load(std::memory_order_relaxed);
+        s->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        fill(payload(s));
+        s->seq.store(seq + 2, std::memory_order_release);
+        ch->front.store(back, std::memory_order_release);
+    }
+};
+
+// Lado do visualizador: so leitura, nunca escreve no segmento.
+class SharedViewReader : public SharedViewSegment {
+public:
+    explicit SharedViewReader(const std::string &name) {
+        const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error("No solver is publishing on " + name + ".");
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SharedViewHeader))) {
+            ::close(fd);
+            throw std::runtime_error("SharedView: " + name + " is not ready.");
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        void *p = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map shared memory " + name + ".");
+        base = static_cast<uint8_t *>(p);
+        if (std::memcmp(header()->magic, sharedViewMagic, sizeof(sharedViewMagic)) != 0 ||
+            header()->version != sharedViewVersion || segmentSize(header()->capacity) != bytes) {
+            ::munmap(base, bytes);
+            base = nullptr;
+            throw std::runtime_error("SharedView: " + name + " has an unknown layout.");
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] const char *isa() const noexcept { return header()->isa; }
+
+    // O processo do solver ainda existe e publicou nos ultimos timeout.
+    [[nodiscard]] bool alive(const std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) const {
+        if (::kill(static_cast<pid_t>(header()->pid), 0) != 0) return false;
+        const auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+        const uint64_t beat = header()->heartbeat.load(std::memory_order_acquire);
+        return static_cast<uint64_t>(now) < beat + static_cast<uint64_t>(timeout.count()) * 1000;
+    }
+
+    // As leituras devolvem false quando nada mudou desde lastSeq ou quando nao
+    // houve copia consistente; o chamador tenta de novo no proximo quadro.
+    bool readInstance(std::vector<City> &cities, double &lowerBound, uint64_t &lastSeq) {
+        return read(SharedChannel::Instance, lastSeq, [&](const uint8_t *p) {
+            SharedInstanceStats stats;
+            std::memcpy(&stats, p, sizeof(stats));
+            if (stats.numCities > capacity()) return false;
+            cities.resize(stats.numCities);
+            const auto *in = reinterpret_cast<const SharedCity *>(p + sizeof(stats));
+            for (size_t i = 0; i < cities.size(); ++i) cities[i] = City{in[i].x, in[i].y, in[i].tag};
+            lowerBound = stats.lowerBound;
+            return true;
+        });
+    }
+
+    bool readSolver(const SharedChannel channel, SharedSolverStats &stats, std::vector<CityId> &best,
+                    std::vector<CityId> &current, uint64_t &lastSeq) {
+        return read(channel, lastSeq, [&](const uint8_t *p) {
+            std::memcpy(&stats, p, sizeof(stats));
+            if (stats.numCities > capacity()) return false;
+            const auto *tours = reinterpret_cast<const CityId *>(p + sizeof(stats));
+            best.assign(tours, tours + stats.numCities);
+            current.assign(tours + capacity(), tours + capacity() + stats.numCities);
+            return true;
+        });
+    }
+
+private:
+    template <typename Copy>
+    bool read(const SharedChannel channel, uint64_t &lastSeq, Copy copy) const {
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            const uint32_t front = channelHeader(channel)->front.load(std::memory_order_acquire);
+            SharedSlot *s = slot(channel, front & 1u);
+            const uint64_t before = s->seq.load(std::memory_order_acquire);
+            if (before == 0) return false; // canal ainda nao publicado
+            if (before & 1u) continue;
+            // a sequencia cresce em cada buffer; somar o indice distingue os dois
+            const uint64_t tag = before * 2 + (front & 1u);
+            if (tag == lastSeq) return false;
+            if (!copy(payload(s))) continue;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s->seq.load(std::memory_order_relaxed) != before) continue;
+            lastSeq = tag;
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif //SALEMAN_SHARED_VIEW_H
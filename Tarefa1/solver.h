@@ -0,0 +1,215 @@
+#ifndef SALEMAN_SOLVER_H
+#define SALEMAN_SOLVER_H
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "annealing.h"
+#include "candidates.h"
+#include "delaunay.h"
+#include "events.h"
+#include "genetic.h"
+#include "hilbert.h"
+#include "localsearch.h"
+#include "map.h"
+#include "multilevel.h"
+#include "partition.h"
+
+// Execucao dos algoritmos com orcamento de tempo, sem interface grafica:
+// cada um roda ate o prazo, reiniciando a partir do melhor tour quando seu
+// proprio criterio de parada chega antes. Hybrid e o GA com o melhor
+// individuo levado a um otimo local sempre que melhora (memetico).
+// Partitioned e Multilevel sao a busca local iterada partindo do tour de
+// runPartitioned ou de runMultilevel em vez do greedy-edge.
+
+enum class Algorithm { Annealing, Genetic, LocalSearch, Hybrid, Partitioned, Multilevel };
+
+inline const char *algorithmName(const Algorithm algorithm) noexcept {
+    switch (algorithm) {
+    case Algorithm::Annealing: return "sa";
+    case Algorithm::Genetic: return "ga";
+    case Algorithm::Hybrid: return "hy";
+    case Algorithm::Partitioned: return "pt";
+    case Algorithm::Multilevel: return "ml";
+    default: return "ls";
+    }
+}
+
+inline Algorithm parseAlgorithm(const std::string &name) {
+    if (name == "sa") return Algorithm::Annealing;
+    if (name == "ga") return Algorithm::Genetic;
+    if (name == "ls") return Algorithm::LocalSearch;
+    if (name == "hy") return Algorithm::Hybrid;
+    if (name == "pt") return Algorithm::Partitioned;
+    if (name == "ml") return Algorithm::Multilevel;
+    throw std::runtime_error("Unknown algorithm " + name + " (expected sa, ga, ls, hy, pt or ml).");
+}
+
+// Renumera pela curva de Hilbert, monta os candidatos de Delaunay e, ate
+// denseLimit cidades, a matriz densa. Feito uma vez por instancia; o resultado
+// pode ser compartilhado entre threads (solveTimed so le o problema).
+inline void prepareProblem(Problem &problem, const size_t denseLimit, const size_t quadrantK = 2) {
+    if (problem.numCities() < 5) throw std::runtime_error("Need at least 5 cities.");
+    renumberCitiesHilbert(problem);
+    CandidateGraph candidates = buildDelaunayCandidates(problem, quadrantK);
+    if (problem.numCities() > denseLimit) {
+        useSparseDistances(problem, std::move(candidates));
+    } else {
+        problem.candidates = std::move(candidates);
+        buildDenseMatrix(problem);
+    }
+}
+
+struct SolveParams {
+    Algorithm algorithm = Algorithm::LocalSearch;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool> *cancel = nullptr; // interrompe antes do prazo quando verdadeiro
+    const SolverObserver *observer = nullptr;  // melhoras, geracoes e temperaturas; false tambem interrompe
+    const AnnealingParams *annealing = nullptr; // nullptr: defaultAnnealingParams
+    const GAParams *genetic = nullptr;          // nullptr: defaultGAParams (GA e hibrido)
+    uint64_t *steps = nullptr;                  // recebe os passos feitos (temperaturas, geracoes ou perturbacoes)
+};
+
+// Double-bridge: troca os segmentos B e C de A B C D. touched recebe as
+// extremidades das quatro arestas novas, que reiniciam a busca local.
+inline void doubleBridge(std::vector<CityId> &order, RNG &rng, std::vector<CityId> &touched) {
+    const size_t n = order.size();
+    size_t cut[3] = {rng.randint(1, n - 3), rng.randint(1, n - 3), rng.randint(1, n - 3)};
+    std::sort(cut, cut + 3);
+    cut[1] = std::max(cut[1], cut[0] + 1);
+    cut[2] = std::max(cut[2], cut[1] + 1);
+    std::rotate(order.begin() + cut[0], order.begin() + cut[1], order.begin() + cut[2]);
+    touched.clear();
+    for (const size_t c : {size_t{0}, cut[0], cut[0] + cut[2] - cut[1], cut[2]}) {
+        touched.push_back(order[(c + n - 1) % n]);
+        touched.push_back(order[c]);
+    }
+}
+
+inline Path solveTimed(const Problem &problem, const SolveParams &params, RNG &rng) {
+    const size_t n = problem.numCities();
+    if (n < 5) throw std::runtime_error("Need at least 5 cities.");
+    bool halted = false; // pedido pelo observer
+    auto stopped = [&]() {
+        return halted || std::chrono::steady_clock::now() >= params.deadline ||
+               (params.cancel && params.cancel->load(std::memory_order_relaxed));
+    };
+    Path best;
+    uint64_t step = 0;
+    auto improve = [&](const Path &candidate) {
+        if (!(candidate.dist + 1e-9 < best.dist)) return;
+        best = candidate;
+        halted |= !notifyImprovement(params.observer, best, step);
+    };
+
+    switch (params.algorithm) {
+    case Algorithm::Annealing: {
+        AnnealingState state;
+        state.problem = &problem;
+        state.params = params.annealing ? *params.annealing : defaultAnnealingParams(n);
+        state.params.actualTemp = state.params.initialTemp;
+        state.currentPath.order.resize(n);
+        std::iota(state.currentPath.order.begin(), state.currentPath.order.end(), 0);
+        std::shuffle(state.currentPath.order.begin(), state.currentPath.order.end(), rng.eng);
+        state.currentPath.dist = routeLength(state.currentPath.order, problem);
+        state.bestPath = state.currentPath;
+        state.bestDist = state.currentPath.dist;
+        improve(state.bestPath);
+        while (!stopped()) {
+            ++step;
+            if (!runAnnealing(state, rng)) {
+                // reaquece a partir do melhor tour
+                state.params.actualTemp = state.params.initialTemp;
+                state.currentPath = state.bestPath;
+                state.stallCounter = 0;
+            }
+            state.bestPath.dist = state.bestDist;
+            improve(state.bestPath);
+            if (params.observer && params.observer->onTemperature)
+                halted |= !notifyTemperature(params.observer, state.iterations, state.params.actualTemp,
+                                             state.bestDist, routePathLength(state.currentPath, problem));
+        }
+        break;
+    }
+    case Algorithm::Genetic:
+    case Algorithm::Hybrid: {
+        GAState state;
+        state.params = params.genetic ? *params.genetic : defaultGAParams(n);
+        state.params.generations = std::numeric_limits<size_t>::max(); // o prazo e quem encerra
+        state.params.deadline = params.deadline;
+        LocalSearchParams lsParams;
+        lsParams.deadline = params.deadline;
+        // no hibrido o otimo local do melhor substitui o pior individuo
+        auto polish = [&]() {
+            if (params.algorithm != Algorithm::Hybrid || !(state.bestPath.dist < best.dist)) return;
+            Path local = state.bestPath;
+            localSearch(local, problem, lsParams);
+            if (!(local.dist + 1e-9 < state.bestPath.dist)) return;
+            state.population.back() = local;
+            sortPopulation(state.population);
+            state.bestPath = local;
+        };
+        // sem tempo sobrando, um unico tour aleatorio ainda da uma resposta valida
+        if (stopped()) state.params.populationSize = 1;
+        initGA(state, problem, rng);
+        polish();
+        improve(state.bestPath);
+        while (!stopped()) {
+            ++step;
+            if (!stepGA(state, problem, rng)) {
+                if (stopped()) break; // geracao interrompida pelo prazo
+                // populacao nova, preservando o melhor individuo
+                initGA(state, problem, rng);
+                state.population.back() = best;
+                sortPopulation(state.population);
+                state.bestPath = state.population.front();
+            }
+            polish();
+            improve(state.bestPath);
+            halted |= !notifyGeneration(params.observer, step, best.dist, state.stallCounter);
+        }
+        break;
+    }
+    default: {
+        // busca local iterada: greedy-edge (particionado ou multinivel), otimo
+        // local e perturbacoes double-bridge aceitas apenas quando melhoram
+        LocalSearchParams lsParams;
+        lsParams.deadline = params.deadline;
+        Path current;
+        if (params.algorithm == Algorithm::Partitioned) {
+            PartitionParams pp;
+            pp.seed = rng.eng();
+            pp.deadline = params.deadline;
+            current = runPartitioned(problem, pp);
+        } else if (params.algorithm == Algorithm::Multilevel) {
+            MultilevelParams mp;
+            mp.seed = rng.eng();
+            mp.deadline = params.deadline;
+            current = runMultilevel(problem, mp);
+        } else {
+            current = greedyEdgeTour(problem);
+        }
+        improve(current);
+        localSearch(current, problem, lsParams);
+        improve(current);
+        std::vector<CityId> touched;
+        while (!stopped()) {
+            ++step;
+            current = best;
+            doubleBridge(current.order, rng, touched);
+            localSearch(current, problem, lsParams, problem.candidates.empty() ? nullptr : &touched);
+            improve(current);
+        }
+        break;
+    }
+    }
+    if (params.steps) *params.steps = step;
+    return best;
+}
+
+#endif //SALEMAN_SOLVER_H
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "saleman.h"
+
+namespace {
+
+int failures = 0;
+
+void check(const bool ok, const char* what)
+{
+    if (ok) return;
+    std::printf("FAIL: %s\n", what);
+    ++failures;
+}
+
+double lastProgress = 0.0;
+
+int onProgress(const double best, double, void*)
+{
+    lastProgress = best;
+    return 0;
+}
+
+double tourLength(const std::vector<double>& x, const std::vector<double>& y, const std::vector<uint32_t>& tour)
+{
+    double total = 0.0;
+    for (size_t i = 0; i < tour.size(); ++i)
+    {
+        const uint32_t a = tour[i], b = tour[(i + 1) % tour.size()];
+        total += std::hypot(x[a] - x[b], y[a] - y[b]);
+    }
+    return total;
+}
+
+double matrixLength(const std::vector<double>& matrix, const std::vector<uint32_t>& tour)
+{
+    const size_t n = tour.size();
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += matrix[tour[i] * n + tour[(i + 1) % n]];
+    return total;
+}
+
+bool isPermutation(const std::vector<uint32_t>& tour)
+{
+    std::vector<bool> seen(tour.size(), false);
+    for (const uint32_t c : tour)
+    {
+        if (c >= tour.size() || seen[c]) return false;
+        seen[c] = true;
+    }
+    return true;
+}
+
+} // namespace
+
+// API C (saleman.h) sobre coordenadas fracionarias e sobre uma matriz do
+// chamador: o comprimento devolvido tem de ser o do tour devolvido, nas
+// unidades do chamador.
+int main()
+{
+    const uint32_t n = 200;
+    std::mt19937_64 gen(7);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> x(n), y(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        x[i] = unit(gen);
+        y[i] = unit(gen);
+    }
+
+    saleman_options options;
+    saleman_default_options(&options);
+    options.algorithm = SALEMAN_LOCAL_SEARCH;
+    options.time_budget = 0.3;
+    options.seed = 1;
+    options.progress = onProgress;
+
+    std::vector<uint32_t> tour(n);
+    double length = 0.0;
+    const int status = saleman_solve_coords(x.data(), y.data(), n, &options, tour.data(), &length);
+    check(status == SALEMAN_OK, saleman_last_error());
+    check(isPermutation(tour), "tour is a permutation");
+
+    const double real = tourLength(x, y, tour);
+    check(std::fabs(length - real) <= 1e-9 * real, "reported length matches the tour");
+    check(std::fabs(lastProgress - real) <= 1e-5 * real, "progress is reported in caller units");
+    // tour otimo no quadrado unitario fica perto de 0.7124 * sqrt(n), cerca de 10
+    check(real < 12.0, "unit-square cities are not collapsed onto a coarse grid");
+
+    // mesma instancia como matriz emprestada
+    std::vector<double> matrix(size_t{n} * n);
+    for (uint32_t i = 0; i < n; ++i)
+        for (uint32_t j = 0; j < n; ++j) matrix[size_t{i} * n + j] = std::hypot(x[i] - x[j], y[i] - y[j]);
+    options.progress = nullptr;
+    std::vector<uint32_t> matrixTour(n);
+    double matrixReported = 0.0;
+    const int matrixStatus = saleman_solve_matrix(matrix.data(), n, &options, matrixTour.data(), &matrixReported);
+    check(matrixStatus == SALEMAN_OK, saleman_last_error());
+    check(isPermutation(matrixTour), "matrix tour is a permutation");
+    const double matrixReal = matrixLength(matrix, matrixTour);
+    check(std::fabs(matrixReported - matrixReal) <= 1e-9 * matrixReal, "matrix length matches the tour");
+    check(matrixReal < 12.0, "matrix solve reaches a good tour");
+
+    // sem coordenadas nao ha candidatos para particionar ou agrupar
+    for (const saleman_algorithm algorithm : {SALEMAN_PARTITIONED, SALEMAN_MULTILEVEL})
+    {
+        options.algorithm = algorithm;
+        check(saleman_solve_matrix(matrix.data(), n, &options, matrixTour.data(), nullptr) == SALEMAN_EINVAL,
+              "matrix input rejects partitioned and multilevel");
+    }
+
+    if (failures) return 1;
+    std::printf("capi: ok\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "annealing.h"
+#include "candidates.h"
+#include "dynamic.h"
+#include "genetic.h"
+#include "map.h"
+
+namespace {
+
+int failures = 0;
+
+void check(const bool ok, const char* what)
+{
+    if (ok) return;
+    std::printf("FAIL: %s\n", what);
+    ++failures;
+}
+
+bool isPermutation(const std::vector<CityId>& order, const size_t n)
+{
+    std::vector<CityId> sorted = order;
+    std::sort(sorted.begin(), sorted.end());
+    if (sorted.size() != n) return false;
+    for (size_t i = 0; i < n; ++i)
+        if (sorted[i] != i) return false;
+    return true;
+}
+
+// Matriz e candidatos atualizados devem bater com os recalculados do zero.
+void checkProblem(const Problem& problem, const char* when)
+{
+    const size_t n = problem.numCities();
+    const std::vector<double> fresh = buildDistanceMatrix(problem);
+    check(problem.distanceMatrix == fresh, when);
+
+    const CandidateGraph& g = problem.candidates;
+    bool graphOk = g.offsets.size() == n + 1;
+    for (size_t i = 0; graphOk && i < n; ++i)
+    {
+        for (uint32_t e = g.offsets[i]; e < g.offsets[i + 1]; ++e)
+        {
+            const CityId j = g.neighbors[e];
+            graphOk = graphOk && j < n && j != i &&
+                      g.dists[e] == static_cast<float>(problem.cityDistance(i, j));
+        }
+    }
+    check(graphOk, when);
+}
+
+} // namespace
+
+// Insercao e remocao de cidades em addCity/removeCity e o reparo dos tours
+// do SA e do GA: os resultados sao comparados com o problema reconstruido.
+int main()
+{
+    RNG rng(7);
+    Problem problem;
+    initializeMap(problem.map, 1000, 1000);
+    populateCities(problem, rng, problem.map, 60);
+    problem.distanceMatrix = buildDistanceMatrix(problem);
+    problem.candidates = buildNearestNeighborCandidates(problem, 6);
+
+    AnnealingState sa;
+    sa.problem = &problem;
+    sa.params = defaultAnnealingParams(problem.numCities());
+    sa.currentPath.order.resize(problem.numCities());
+    for (size_t i = 0; i < problem.numCities(); ++i) sa.currentPath.order[i] = static_cast<CityId>(i);
+    sa.currentPath.dist = routeLength(sa.currentPath.order, problem);
+    sa.bestPath = sa.currentPath;
+    sa.bestDist = sa.bestPath.dist;
+
+    GAState ga;
+    ga.params = defaultGAParams(problem.numCities());
+    ga.params.populationSize = 16;
+    initGA(ga, problem, rng);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        City city;
+        city.x = static_cast<unsigned int>(rng.randint(0, 999));
+        city.y = static_cast<unsigned int>(rng.randint(0, 999));
+        const CityId id = addCity(problem, city);
+        check(id + 1 == problem.numCities(), "addCity returns the last index");
+        insertCity(sa, id);
+        insertCity(ga, problem, id);
+        checkProblem(problem, "problem after addCity");
+
+        const auto removed = static_cast<CityId>(rng.randint(0, problem.numCities() - 1));
+        const CityId moved = removeCity(problem, removed);
+        check(moved == problem.numCities(), "removeCity returns the old last index");
+        eraseCity(sa, removed, moved);
+        eraseCity(ga, problem, removed, moved);
+        checkProblem(problem, "problem after removeCity");
+
+        const size_t n = problem.numCities();
+        check(isPermutation(sa.currentPath.order, n) && isPermutation(sa.bestPath.order, n), "SA tours");
+        check(sa.bestDist == routeLength(sa.bestPath.order, problem), "SA best length");
+        bool gaOk = isPermutation(ga.bestPath.order, n);
+        for (const Path& p : ga.population)
+            gaOk = gaOk && isPermutation(p.order, n) && p.dist == routeLength(p.order, problem);
+        check(gaOk, "GA population");
+    }
+
+    // insercao mais barata em um quadrado: o ponto do meio de uma aresta
+    Problem square;
+    for (const auto& [x, y] : {std::pair{0u, 0u}, {10u, 0u}, {10u, 10u}, {0u, 10u}})
+    {
+        City c;
+        c.x = x;
+        c.y = y;
+        square.cities.push_back(c);
+    }
+    Path tour;
+    tour.order = {0, 1, 2, 3};
+    City mid;
+    mid.x = 10;
+    mid.y = 5;
+    square.cities.push_back(mid);
+    insertCheapest(tour, square, 4);
+    check((tour.order == std::vector<CityId>{0, 1, 4, 2, 3}), "insertCheapest picks the cheapest edge");
+
+    bool threw = false;
+    try
+    {
+        removeFromPath(tour, 9, 9);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    check(threw, "removeFromPath rejects a missing city");
+
+    Problem borrowed = square;
+    const std::vector<double> external = buildDistanceMatrix(square);
+    borrowed.externalMatrix = external.data();
+    threw = false;
+    try
+    {
+        addCity(borrowed, mid);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    check(threw && borrowed.numCities() == 5, "addCity rejects a borrowed matrix");
+
+    if (failures) return 1;
+    std::printf("dynamic: ok\n");
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <vector>
+
+#include "lod.h"
+#include "map.h"
+
+namespace {
+
+int failures = 0;
+
+void check(const bool ok, const char* what)
+{
+    if (ok) return;
+    std::printf("FAIL: %s\n", what);
+    ++failures;
+}
+
+struct Point
+{
+    float x, y;
+};
+
+bool same(const Point& a, const float x, const float y) { return a.x == x && a.y == y; }
+
+std::vector<City> citiesAt(const std::vector<std::pair<unsigned int, unsigned int>>& xy)
+{
+    std::vector<City> cities;
+    for (const auto& [x, y] : xy)
+    {
+        City c;
+        c.x = x;
+        c.y = y;
+        cities.push_back(c);
+    }
+    return cities;
+}
+
+std::vector<CityId> identity(const size_t n)
+{
+    std::vector<CityId> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = static_cast<CityId>(i);
+    return order;
+}
+
+ViewTransform panel(const float zoom, const float size)
+{
+    ViewTransform view;
+    view.zoom = zoom;
+    view.right = size;
+    view.bottom = size;
+    return view;
+}
+
+} // namespace
+
+// Decimacao do tour e pontos de cidade do nivel de detalhe (lod.h), sem
+// janela: so a geometria em coordenadas de tela e conferida.
+int main()
+{
+    std::vector<Point> out;
+
+    // tres cidades no mesmo pixel viram um ponto; o ciclo volta ao inicio
+    {
+        const std::vector<City> cities = citiesAt({{0, 0}, {1, 0}, {2, 0}, {100, 0}, {100, 100}});
+        decimateTour(identity(cities.size()), cities, panel(0.1f, 100.0f), out);
+        check(out.size() == 4, "points in one pixel are merged");
+        check(out.size() == 4 && same(out[0], 0.0f, 0.0f) && same(out[1], 10.0f, 0.0f) &&
+                  same(out[2], 10.0f, 10.0f) && same(out[3], 0.0f, 0.0f),
+              "merged polyline keeps the first point of each pixel");
+    }
+
+    // trecho fora da tela, sempre a direita: so a entrada e a ultima saida ficam
+    {
+        const std::vector<City> cities =
+            citiesAt({{10, 10}, {200, 10}, {300, 20}, {400, 30}, {250, 50}, {20, 50}});
+        decimateTour(identity(cities.size()), cities, panel(1.0f, 100.0f), out);
+        check(out.size() == 5, "off-screen run collapses to one segment");
+        bool hidden = true;
+        for (const Point& p : out) hidden = hidden && !same(p, 300.0f, 20.0f) && !same(p, 400.0f, 30.0f);
+        check(hidden, "inner off-screen points are dropped");
+        check(out.size() == 5 && same(out[1], 200.0f, 10.0f) && same(out[2], 250.0f, 50.0f),
+              "off-screen run keeps its endpoints");
+    }
+
+    // a volta ao inicio caiu no pixel do ultimo ponto: o ciclo e fechado mesmo assim
+    {
+        const std::vector<City> cities = citiesAt({{0, 0}, {500, 0}, {500, 500}, {3, 3}});
+        decimateTour(identity(cities.size()), cities, panel(0.1f, 100.0f), out);
+        check(out.size() == 5 && same(out.back(), out.front().x, out.front().y), "loop is closed");
+    }
+
+    // cidades repetidas no mesmo pixel: um ponto, mas todas contam como visiveis
+    {
+        const std::vector<City> cities = citiesAt({{1, 1}, {1, 1}, {2, 1}, {20, 20}});
+        std::vector<uint8_t> occupied;
+        const size_t visible = cityPoints(cities, panel(1.0f, 10.0f), occupied, out);
+        check(visible == 3, "cityPoints counts visible cities");
+        check(out.size() == 2 && same(out[0], 1.5f, 1.5f) && same(out[1], 2.5f, 1.5f),
+              "cityPoints emits one centered point per pixel");
+    }
+
+    if (failures) return 1;
+    std::printf("lod: ok\n");
+    return 0;
+}
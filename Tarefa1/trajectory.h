@@ -0,0 +1,360 @@
+#ifndef SALEMAN_TRAJECTORY_H
+#define SALEMAN_TRAJECTORY_H
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "map.h"
+
+// Trajetoria de uma execucao: cada melhora do melhor tour vira um registro no
+// arquivo binario, com as arestas removidas e adicionadas em relacao ao
+// registro anterior e um keyframe (tour completo) a cada keyframeInterval
+// registros. O arquivo comeca com as cidades, entao a reproducao nao precisa
+// da instancia original.
+//
+// Layout: TrajectoryHeader, numCities x TrajectoryCity e depois registros
+// TrajectoryRecord seguidos de count uint32. Keyframe: count = n, a ordem.
+// Delta: count = 4k, k arestas removidas (pares) seguidas de k adicionadas.
+
+struct TrajectoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numCities;
+    uint32_t keyframeInterval;
+    uint32_t reserved;
+};
+
+struct TrajectoryCity {
+    uint32_t x, y, tag;
+};
+
+enum class TrajectoryKind : uint32_t { Keyframe = 0, Delta = 1 };
+
+struct TrajectoryRecord {
+    TrajectoryKind kind;
+    uint32_t count;
+    uint64_t step; // iteracao ou geracao do solver
+    uint64_t micros; // desde a abertura do arquivo
+    double dist;
+};
+
+inline constexpr char trajectoryMagic[8] = {'S', 'L', 'M', 'N', 'T', 'R', 'A', 'J'};
+inline constexpr uint32_t trajectoryVersion = 1;
+
+// Grava a trajetoria numa thread propria: record() so copia a ordem para a
+// fila, e o calculo do delta e a escrita ficam fora da thread do solver.
+class TrajectoryWriter {
+public:
+    TrajectoryWriter() = default;
+    TrajectoryWriter(const TrajectoryWriter &) = delete;
+    TrajectoryWriter &operator=(const TrajectoryWriter &) = delete;
+    ~TrajectoryWriter() { close(); }
+
+    void open(const std::string &path, const std::vector<City> &cities, const uint32_t keyframeInterval = 64) {
+        close();
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot write " + path + ".");
+        TrajectoryHeader header{};
+        std::memcpy(header.magic, trajectoryMagic, sizeof(header.magic));
+        header.version = trajectoryVersion;
+        header.numCities = static_cast<uint32_t>(cities.size());
+        header.keyframeInterval = std::max(1u, keyframeInterval);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const City &c : cities) {
+            const TrajectoryCity tc{c.x, c.y, c.tag};
+            out.write(reinterpret_cast<const char *>(&tc), sizeof(tc));
+        }
+        interval = header.keyframeInterval;
+        sinceKeyframe = interval; // o primeiro registro e sempre keyframe
+        prevNext.clear();
+        start = std::chrono::steady_clock::now();
+        stopping = false;
+        writer = std::thread([this]() { drain(); });
+    }
+
+    [[nodiscard]] bool isOpen() const noexcept { return writer.joinable(); }
+
+    // Chamado pelo solver a cada melhora do melhor tour.
+    void record(const std::vector<CityId> &order, const double dist, const uint64_t step) {
+        if (!isOpen()) return;
+        const auto micros = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            pending.push_back({order, dist, step, micros});
+        }
+        cv.notify_one();
+    }
+
+    // Escreve o que ainda estiver na fila e fecha o arquivo.
+    void close() {
+        if (!isOpen()) return;
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            stopping = true;
+        }
+        cv.notify_one();
+        writer.join();
+        out.close();
+    }
+
+private:
+    struct Snapshot {
+        std::vector<CityId> order;
+        double dist;
+        uint64_t step, micros;
+    };
+
+    std::ofstream out;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Snapshot> pending;
+    bool stopping = false;
+    uint32_t interval = 64, sinceKeyframe = 0;
+    std::chrono::steady_clock::time_point start;
+    std::vector<CityId> prevNext, next, payload;
+
+    void drain() {
+        std::unique_lock<std::mutex> lk(mutex);
+        while (true) {
+            cv.wait(lk, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) break;
+            std::deque<Snapshot> batch;
+            batch.swap(pending);
+            lk.unlock();
+            for (const Snapshot &s : batch) write(s);
+            out.flush();
+            lk.lock();
+        }
+    }
+
+    void write(const Snapshot &s) {
+        const size_t n = s.order.size();
+        if (n == 0) return;
+        next.resize(n);
+        for (size_t i = 0; i < n; ++i) next[s.order[i]] = s.order[(i + 1) % n];
+
+        TrajectoryRecord rec{TrajectoryKind::Delta, 0, s.step, s.micros, s.dist};
+        bool keyframe = ++sinceKeyframe >= interval || prevNext.size() != n;
+        if (!keyframe) {
+            // arestas de um lado que nao existem no outro, em qualquer sentido
+            payload.clear();
+            for (CityId a = 0; a < n; ++a) {
+                const CityId b = prevNext[a];
+                if (next[a] != b && next[b] != a) payload.insert(payload.end(), {a, b});
+            }
+            for (CityId a = 0; a < n; ++a) {
+                const CityId b = next[a];
+                if (prevNext[a] != b && prevNext[b] != a) payload.insert(payload.end(), {a, b});
+            }
+            // delta maior que o tour inteiro: compensa gravar um keyframe
+            keyframe = payload.size() >= n;
+        }
+        if (keyframe) {
+            rec.kind = TrajectoryKind::Keyframe;
+            payload.assign(s.order.begin(), s.order.end());
+            sinceKeyframe = 0;
+        }
+        rec.count = static_cast<uint32_t>(payload.size());
+        out.write(reinterpret_cast<const char *>(&rec), sizeof(rec));
+        out.write(reinterpret_cast<const char *>(payload.data()),
+                  static_cast<std::streamsize>(payload.size() * sizeof(CityId)));
+        prevNext.swap(next);
+    }
+};
+
+// Leitura de uma trajetoria por mmap. O indice dos registros e montado na
+// abertura; tourAt() parte do keyframe mais proximo ou da posicao atual e
+// aplica os deltas sobre uma lista de adjacencia. Um registro truncado no fim
+// (execucao interrompida) e ignorado.
+class TrajectoryReader {
+public:
+    struct Frame {
+        uint64_t step, micros;
+        double dist;
+        size_t offset; // inicio do TrajectoryRecord no arquivo
+        size_t keyframe; // indice do keyframe que precede este registro
+    };
+
+    explicit TrajectoryReader(const std::string &path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + ".");
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TrajectoryHeader))) {
+            ::close(fd);
+            throw std::runtime_error("Trajectory: " + path + " is too short.");
+        }
+        bytes = static_cast<size_t>(st.st_size);
+        void *p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot map " + path + ".");
+        data = static_cast<const uint8_t *>(p);
+        try {
+            index();
+        } catch (...) {
+            ::munmap(const_cast<uint8_t *>(data), bytes);
+            throw;
+        }
+    }
+
+    TrajectoryReader(const TrajectoryReader &) = delete;
+    TrajectoryReader &operator=(const TrajectoryReader &) = delete;
+    ~TrajectoryReader() { ::munmap(const_cast<uint8_t *>(data), bytes); }
+
+    [[nodiscard]] const std::vector<City> &cities() const noexcept { return cityList; }
+    [[nodiscard]] size_t size() const noexcept { return frames.size(); }
+    [[nodiscard]] const Frame &frame(const size_t i) const noexcept { return frames[i]; }
+
+    // Ultimo registro com micros <= t (0 se t for anterior ao primeiro).
+    [[nodiscard]] size_t indexAt(const uint64_t micros) const noexcept {
+        const auto it = std::upper_bound(frames.begin(), frames.end(), micros,
+                                         [](const uint64_t t, const Frame &f) { return t < f.micros; });
+        return it == frames.begin() ? 0 : static_cast<size_t>(it - frames.begin()) - 1;
+    }
+
+    // Tour do registro i. Avancar a partir da posicao atual custa so os deltas
+    // intermediarios; voltar recomeca do keyframe.
+    void tourAt(const size_t i, std::vector<CityId> &order) {
+        if (i >= frames.size()) throw std::runtime_error("Trajectory: record out of range.");
+        size_t from = frames[i].keyframe;
+        if (current != none && current <= i && current >= from) {
+            from = current + 1;
+        } else {
+            loadKeyframe(from);
+            ++from;
+        }
+        for (size_t r = from; r <= i; ++r) applyDelta(r);
+        current = i;
+        walk(order);
+    }
+
+private:
+    static constexpr CityId noCity = std::numeric_limits<CityId>::max();
+    static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+    const uint8_t *data = nullptr;
+    size_t bytes = 0;
+    std::vector<City> cityList;
+    std::vector<Frame> frames;
+    std::vector<CityId> adj; // dois vizinhos por cidade
+    size_t current = none;
+
+    // registros so tem alinhamento de 4 bytes no arquivo
+    [[nodiscard]] TrajectoryRecord record(const size_t r) const noexcept {
+        TrajectoryRecord rec{};
+        std::memcpy(&rec, data + frames[r].offset, sizeof(rec));
+        return rec;
+    }
+    [[nodiscard]] const CityId *payload(const size_t r) const noexcept {
+        return reinterpret_cast<const CityId *>(data + frames[r].offset + sizeof(TrajectoryRecord));
+    }
+
+    void index() {
+        TrajectoryHeader header{};
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, trajectoryMagic, sizeof(header.magic)) != 0)
+            throw std::runtime_error("Trajectory: bad magic.");
+        if (header.version != trajectoryVersion) throw std::runtime_error("Trajectory: unsupported version.");
+        const size_t n = header.numCities;
+        size_t offset = sizeof(header) + n * sizeof(TrajectoryCity);
+        if (offset > bytes) throw std::runtime_error("Trajectory: truncated city table.");
+        cityList.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            TrajectoryCity tc{};
+            std::memcpy(&tc, data + sizeof(header) + i * sizeof(tc), sizeof(tc));
+            cityList[i] = City{tc.x, tc.y, tc.tag};
+        }
+
+        size_t keyframe = none;
+        while (offset + sizeof(TrajectoryRecord) <= bytes) {
+            TrajectoryRecord rec{};
+            std::memcpy(&rec, data + offset, sizeof(rec));
+            const size_t end = offset + sizeof(rec) + static_cast<size_t>(rec.count) * sizeof(CityId);
+            if (end > bytes) break;
+            if (rec.kind == TrajectoryKind::Keyframe) {
+                if (rec.count != n) throw std::runtime_error("Trajectory: keyframe size mismatch.");
+                keyframe = frames.size();
+            } else if (rec.kind != TrajectoryKind::Delta || rec.count % 4 != 0 || keyframe == none) {
+                throw std::runtime_error("Trajectory: corrupt record.");
+            }
+            frames.push_back({rec.step, rec.micros, rec.dist, offset, keyframe});
+            offset = end;
+        }
+        if (frames.empty()) throw std::runtime_error("Trajectory: no records.");
+    }
+
+    void loadKeyframe(const size_t r) {
+        const size_t n = cityList.size();
+        const CityId *order = payload(r);
+        adj.assign(2 * n, noCity);
+        for (size_t i = 0; i < n; ++i) {
+            const CityId a = order[i], b = order[(i + 1) % n];
+            adj[2 * a + 1] = b;
+            adj[2 * b] = a;
+        }
+    }
+
+    void applyDelta(const size_t r) {
+        const TrajectoryRecord rec = record(r);
+        if (rec.kind == TrajectoryKind::Keyframe) {
+            loadKeyframe(r);
+            return;
+        }
+        const CityId *p = payload(r);
+        const size_t half = rec.count / 2;
+        for (size_t e = 0; e < half; e += 2) {
+            unlink(p[e], p[e + 1]);
+            unlink(p[e + 1], p[e]);
+        }
+        for (size_t e = half; e < rec.count; e += 2) {
+            link(p[e], p[e + 1]);
+            link(p[e + 1], p[e]);
+        }
+    }
+
+    void unlink(const CityId a, const CityId b) noexcept {
+        if (adj[2 * a] == b)
+            adj[2 * a] = noCity;
+        else if (adj[2 * a + 1] == b)
+            adj[2 * a + 1] = noCity;
+    }
+
+    void link(const CityId a, const CityId b) noexcept {
+        if (adj[2 * a] == noCity)
+            adj[2 * a] = b;
+        else
+            adj[2 * a + 1] = b;
+    }
+
+    // Percorre o ciclo a partir da cidade 0; o sentido nao importa para desenhar.
+    void walk(std::vector<CityId> &order) const {
+        const size_t n = cityList.size();
+        order.clear();
+        order.reserve(n);
+        CityId prev = noCity, c = 0;
+        for (size_t i = 0; i < n; ++i) {
+            order.push_back(c);
+            const CityId nextCity = adj[2 * c] != prev ? adj[2 * c] : adj[2 * c + 1];
+            prev = c;
+            c = nextCity;
+        }
+    }
+};
+
+#endif //SALEMAN_TRAJECTORY_H
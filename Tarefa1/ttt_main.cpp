@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "instance_io.h"
+#include "solver.h"
+
+#define TTT_DENSE_MATRIX_LIMIT 5000
+
+namespace {
+
+struct Options {
+    size_t runs = 20;        // sementes por instancia e algoritmo
+    double budget = 2.0;     // segundos por execucao
+    std::vector<double> targets{5.0, 2.0, 1.0, 0.5}; // desvios alvo em %
+    std::vector<Algorithm> algorithms{Algorithm::Annealing, Algorithm::Genetic, Algorithm::LocalSearch};
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int cities = 1000; // instancias aleatorias sem corpus
+    size_t instances = 3;
+    double optimum = 0.0;    // referencia explicita (uma instancia); 0 = melhor valor visto
+    std::string out = "ttt";
+    std::vector<std::string> files;
+};
+
+struct Instance {
+    std::string name;
+    Problem problem;
+};
+
+// Uma execucao: cada melhora como (segundos desde o inicio, distancia).
+struct Run {
+    size_t instance, algorithm;
+    uint64_t seed;
+    std::vector<std::pair<double, double>> trace;
+};
+
+template <typename T, typename F>
+std::vector<T> splitList(const std::string &s, F &&parse)
+{
+    std::vector<T> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) out.push_back(parse(item));
+    return out;
+}
+
+// Quantil empirico (tipo 7) de tempos ja ordenados; infinito quando cai
+// entre as execucoes que nao chegaram ao alvo.
+double quantile(const std::vector<double> &sorted, const double q)
+{
+    const double pos = q * static_cast<double>(sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(pos);
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    if (std::isinf(sorted[hi])) return std::numeric_limits<double>::infinity();
+    return sorted[lo] + (pos - static_cast<double>(lo)) * (sorted[hi] - sorted[lo]);
+}
+
+std::string seconds(const double s)
+{
+    if (std::isinf(s)) return "-";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.4f", s);
+    return buf;
+}
+
+} // namespace
+
+// saleman_ttt [--runs r] [--budget s] [--targets 5,2,1] [--algorithms sa,ga,ls,hy,pt,ml] [--threads t]
+//             [--cities n --instances m] [--optimum v] [--out prefixo] [arquivos TSPLIB...]
+// Tempo ate o alvo: cada execucao registra quando cruza cada desvio alvo em
+// relacao a referencia (otimo informado ou melhor valor visto na instancia).
+// Grava <prefixo>_runs.csv (um tempo por execucao e alvo, vazio se nao
+// chegou) e <prefixo>_plot.csv (pontos do grafico TTT, probabilidade
+// (i - 0.5) / n); o resumo com quantis vai para a saida padrao.
+int main(int argc, char** argv)
+{
+    Options opt;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--runs") == 0 && hasValue) opt.runs = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--budget") == 0 && hasValue) opt.budget = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--targets") == 0 && hasValue)
+                opt.targets = splitList<double>(argv[++i], [](const std::string& s) { return std::stod(s); });
+            else if (std::strcmp(argv[i], "--algorithms") == 0 && hasValue)
+                opt.algorithms = splitList<Algorithm>(argv[++i], [](const std::string& s) { return parseAlgorithm(s); });
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) opt.threads = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--cities") == 0 && hasValue) opt.cities = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--instances") == 0 && hasValue) opt.instances = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--optimum") == 0 && hasValue) opt.optimum = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--out") == 0 && hasValue) opt.out = argv[++i];
+            else opt.files.push_back(argv[i]);
+        }
+        if (opt.runs == 0 || !(opt.budget > 0.0) || opt.threads == 0 || opt.targets.empty() || opt.algorithms.empty())
+            throw std::runtime_error("need --runs, --budget, --threads, --targets and --algorithms to be non-empty/positive.");
+        std::sort(opt.targets.rbegin(), opt.targets.rend());
+
+        std::vector<Instance> instances;
+        if (opt.files.empty())
+        {
+            RNG rng(1);
+            for (size_t i = 0; i < opt.instances; ++i)
+            {
+                Instance inst{"uniform" + std::to_string(opt.cities) + "_" + std::to_string(i), Problem()};
+                initializeMap(inst.problem.map, 10000, 10000);
+                populateCities(inst.problem, rng, inst.problem.map, opt.cities);
+                instances.push_back(std::move(inst));
+            }
+        }
+        else
+        {
+            for (const std::string& file : opt.files)
+            {
+                Instance inst;
+                inst.problem = readTSPLIB(file, &inst.name);
+                if (inst.name.empty()) inst.name = file;
+                instances.push_back(std::move(inst));
+            }
+        }
+        if (opt.optimum > 0.0 && instances.size() != 1)
+            throw std::runtime_error("--optimum applies to a single instance.");
+        for (Instance& inst : instances) prepareProblem(inst.problem, TTT_DENSE_MATRIX_LIMIT);
+
+        std::vector<Run> runs;
+        for (size_t i = 0; i < instances.size(); ++i)
+            for (size_t a = 0; a < opt.algorithms.size(); ++a)
+                for (size_t s = 0; s < opt.runs; ++s) runs.push_back({i, a, 1000 * i + s + 1, {}});
+
+        std::printf("kernels: %s, threads: %zu, %zu runs of %.2f s\n", isaName(kernels().isa), opt.threads,
+                    runs.size(), opt.budget);
+        std::fflush(stdout);
+
+        // execucoes independentes em paralelo; cada uma so anota as melhoras
+        const auto budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(opt.budget));
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t r = next++; r < runs.size(); r = next++)
+            {
+                Run& run = runs[r];
+                SolveParams params;
+                params.algorithm = opt.algorithms[run.algorithm];
+                const auto start = std::chrono::steady_clock::now();
+                params.deadline = start + budget;
+                SolverObserver observer;
+                observer.onImprovement = [&](const Path& best, uint64_t) {
+                    run.trace.emplace_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+                                           best.dist);
+                    return true;
+                };
+                params.observer = &observer;
+                RNG rng(run.seed);
+                solveTimed(instances[run.instance].problem, params, rng);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < std::min(opt.threads, runs.size()); ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+
+        std::vector<double> reference(instances.size(), std::numeric_limits<double>::infinity());
+        for (const Run& run : runs)
+            if (!run.trace.empty()) reference[run.instance] = std::min(reference[run.instance], run.trace.back().second);
+        if (opt.optimum > 0.0) reference[0] = opt.optimum;
+
+        // tempo do primeiro cruzamento de cada alvo
+        auto crossing = [&](const Run& run, const double target) {
+            const double limit = reference[run.instance] * (1.0 + target / 100.0);
+            for (const auto& [t, d] : run.trace)
+                if (d <= limit + 1e-9) return t;
+            return std::numeric_limits<double>::infinity();
+        };
+
+        std::ofstream runsCsv(opt.out + "_runs.csv");
+        std::ofstream plotCsv(opt.out + "_plot.csv");
+        if (!runsCsv || !plotCsv) throw std::runtime_error("cannot write " + opt.out + "_*.csv.");
+        runsCsv.precision(12);
+        runsCsv << "instance,cities,algorithm,seed,reference,final,target_gap_pct,time_s\n";
+        plotCsv << "instance,algorithm,target_gap_pct,rank,time_s,probability\n";
+        for (const Run& run : runs)
+        {
+            const Instance& inst = instances[run.instance];
+            for (const double target : opt.targets)
+            {
+                const double t = crossing(run, target);
+                runsCsv << inst.name << ',' << inst.problem.numCities() << ',' << algorithmName(opt.algorithms[run.algorithm])
+                        << ',' << run.seed << ',' << reference[run.instance] << ','
+                        << (run.trace.empty() ? 0.0 : run.trace.back().second) << ',' << target << ','
+                        << (std::isinf(t) ? "" : seconds(t)) << '\n';
+            }
+        }
+
+        std::printf("%-20s %-4s %8s %8s %10s %10s %10s %10s\n", "instance", "alg", "target%", "success",
+                    "q10 (s)", "median", "q90", "mean ok");
+        for (size_t i = 0; i < instances.size(); ++i)
+        {
+            for (size_t a = 0; a < opt.algorithms.size(); ++a)
+            {
+                for (const double target : opt.targets)
+                {
+                    std::vector<double> times;
+                    for (const Run& run : runs)
+                        if (run.instance == i && run.algorithm == a) times.push_back(crossing(run, target));
+                    std::sort(times.begin(), times.end());
+                    size_t ok = 0;
+                    double sum = 0.0;
+                    for (size_t k = 0; k < times.size(); ++k)
+                    {
+                        if (std::isinf(times[k])) continue;
+                        ++ok;
+                        sum += times[k];
+                        plotCsv << instances[i].name << ',' << algorithmName(opt.algorithms[a]) << ',' << target << ','
+                                << ok << ',' << seconds(times[k]) << ','
+                                << (static_cast<double>(ok) - 0.5) / static_cast<double>(times.size()) << '\n';
+                    }
+                    std::printf("%-20s %-4s %8.2f %5zu/%-2zu %10s %10s %10s %10s\n", instances[i].name.c_str(),
+                                algorithmName(opt.algorithms[a]), target, ok, times.size(),
+                                seconds(quantile(times, 0.1)).c_str(), seconds(quantile(times, 0.5)).c_str(),
+                                seconds(quantile(times, 0.9)).c_str(),
+                                ok ? seconds(sum / static_cast<double>(ok)).c_str() : "-");
+                }
+            }
+        }
+        std::printf("wrote %s_runs.csv and %s_plot.csv\n", opt.out.c_str(), opt.out.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_ttt: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
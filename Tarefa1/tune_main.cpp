@@ -0,0 +1,175 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "instance_io.h"
+#include "solver.h"
+#include "tuning.h"
+
+#define TUNE_DENSE_MATRIX_LIMIT 5000
+
+namespace {
+
+// Classes de tamanho: os parametros vencedores saem por classe.
+struct SizeClass {
+    const char *name;
+    size_t maxCities;
+    unsigned int generated; // tamanho das instancias aleatorias da classe
+};
+
+const SizeClass sizeClasses[] = {{"n<=200", 200, 100}, {"n<=1000", 1000, 500}, {"n>1000", std::numeric_limits<size_t>::max(), 2000}};
+
+size_t classOf(const size_t n)
+{
+    size_t c = 0;
+    while (n > sizeClasses[c].maxCities) ++c;
+    return c;
+}
+
+struct Options {
+    double budget = 0.25;   // segundos por execucao
+    size_t configs = 16;    // configuracoes por corrida, incluindo a padrao
+    size_t instances = 20;  // instancias aleatorias por classe sem corpus
+    RaceParams race;
+    uint64_t seed = 1;
+    std::vector<std::string> files;
+};
+
+void printAnnealing(const AnnealingParams &p)
+{
+    std::printf("    AnnealingParams: initialTemp = %.6g; finalTemp = %.6g; alpha = %.6g; neighborsPerTemp = %u; "
+                "stallLimit = %u; candidateMoveRate = %.3f;\n",
+                p.initialTemp, p.finalTemp, p.alpha, p.neighborsPerTemp, p.stallLimit, p.candidateMoveRate);
+}
+
+void printGenetic(const GAParams &p)
+{
+    std::printf("    GAParams: populationSize = %zu; elitism = %zu; tournamentK = %zu; mutationRate = %.4f; "
+                "stallLimit = %zu; numMutations = %zu;\n",
+                p.populationSize, p.elitism, p.tournamentK, p.mutationRate, p.stallLimit, p.numMutations);
+}
+
+// Desvio medio de uma configuracao para o melhor custo de cada instancia,
+// nas instancias em que ela rodou.
+double meanGap(const RaceResult &r, const size_t config)
+{
+    double sum = 0.0;
+    size_t count = 0;
+    for (const auto &row : r.costs)
+    {
+        if (std::isnan(row[config])) continue;
+        double best = std::numeric_limits<double>::infinity();
+        for (const double c : row)
+            if (!std::isnan(c)) best = std::min(best, c);
+        sum += row[config] / best - 1.0;
+        ++count;
+    }
+    return count ? sum / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
+}
+
+void tuneClass(const SizeClass &sc, const std::vector<Problem> &corpus, const Options &opt, RNG &rng)
+{
+    size_t totalCities = 0;
+    for (const Problem &p : corpus) totalCities += p.numCities();
+    const size_t n = totalCities / corpus.size(); // tamanho representativo da classe
+    const auto budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(opt.budget));
+
+    std::vector<AnnealingParams> annealing{defaultAnnealingParams(n)};
+    std::vector<GAParams> genetic{defaultGAParams(n)};
+    while (annealing.size() < opt.configs) annealing.push_back(sampleAnnealingParams(rng, n));
+    while (genetic.size() < opt.configs) genetic.push_back(sampleGAParams(rng));
+
+    // mesma semente para todas as configuracoes na mesma instancia
+    auto run = [&](const Algorithm algorithm, const size_t config, const size_t instance) {
+        SolveParams params;
+        params.algorithm = algorithm;
+        params.annealing = &annealing[config];
+        params.genetic = &genetic[config];
+        params.deadline = std::chrono::steady_clock::now() + budget;
+        RNG local(opt.seed * 7919 + instance);
+        return solveTimed(corpus[instance], params, local).dist;
+    };
+
+    std::printf("%s: %zu instances, mean %zu cities, %zu configurations, %.3f s per run\n", sc.name, corpus.size(), n,
+                opt.configs, opt.budget);
+    const RaceResult sa = race(opt.configs, corpus.size(), opt.race,
+                               [&](const size_t c, const size_t i) { return run(Algorithm::Annealing, c, i); });
+    std::printf("  annealing: winner #%zu after %zu instances, %zu survivors, mean gap %.2f%% (default %.2f%%)\n",
+                sa.winner, sa.instancesUsed, sa.survivors.size(), 100.0 * meanGap(sa, sa.winner), 100.0 * meanGap(sa, 0));
+    printAnnealing(annealing[sa.winner]);
+
+    const RaceResult ga = race(opt.configs, corpus.size(), opt.race,
+                               [&](const size_t c, const size_t i) { return run(Algorithm::Genetic, c, i); });
+    std::printf("  genetic: winner #%zu after %zu instances, %zu survivors, mean gap %.2f%% (default %.2f%%)\n",
+                ga.winner, ga.instancesUsed, ga.survivors.size(), 100.0 * meanGap(ga, ga.winner), 100.0 * meanGap(ga, 0));
+    printGenetic(genetic[ga.winner]);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+// saleman_tune [--budget s] [--configs k] [--instances m] [--threads t] [--seed s] [arquivos TSPLIB...]
+// Sem arquivos, cada classe de tamanho usa m instancias uniformes aleatorias.
+int main(int argc, char** argv)
+{
+    Options opt;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--budget") == 0 && hasValue) opt.budget = std::stod(argv[++i]);
+            else if (std::strcmp(argv[i], "--configs") == 0 && hasValue) opt.configs = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--instances") == 0 && hasValue) opt.instances = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) opt.race.threads = std::stoul(argv[++i]);
+            else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) opt.seed = std::stoull(argv[++i]);
+            else opt.files.push_back(argv[i]);
+        }
+        if (!(opt.budget > 0.0) || opt.configs < 2 || opt.race.threads == 0)
+            throw std::runtime_error("need --budget > 0, --configs >= 2 and --threads >= 1.");
+
+        std::vector<std::vector<Problem>> corpus(std::size(sizeClasses));
+        RNG rng(opt.seed);
+        if (opt.files.empty())
+        {
+            for (size_t c = 0; c < corpus.size(); ++c)
+            {
+                for (size_t i = 0; i < opt.instances; ++i)
+                {
+                    Problem p;
+                    initializeMap(p.map, 10000, 10000);
+                    populateCities(p, rng, p.map, sizeClasses[c].generated);
+                    corpus[c].push_back(std::move(p));
+                }
+            }
+        }
+        else
+        {
+            for (const std::string& file : opt.files)
+            {
+                Problem p = readTSPLIB(file);
+                corpus[classOf(p.numCities())].push_back(std::move(p));
+            }
+        }
+
+        std::printf("kernels: %s, threads: %zu\n", isaName(kernels().isa), opt.race.threads);
+        for (size_t c = 0; c < corpus.size(); ++c)
+        {
+            if (corpus[c].empty()) continue;
+            for (Problem& p : corpus[c]) prepareProblem(p, TUNE_DENSE_MATRIX_LIMIT);
+            tuneClass(sizeClasses[c], corpus[c], opt, rng);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "saleman_tune: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
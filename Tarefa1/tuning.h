@@ -0,0 +1,197 @@
+#ifndef SALEMAN_TUNING_H
+#define SALEMAN_TUNING_H
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "annealing.h"
+#include "genetic.h"
+#include "map.h"
+
+// Ajuste automatico de parametros por corrida (F-race, Birattari et al. 2002):
+// as configuracoes vivas rodam instancia por instancia; a partir de
+// firstTest instancias, o teste de Friedman sobre os postos elimina as que
+// ficam significativamente atras da melhor.
+
+// Quantil da normal padrao (aproximacao racional de Acklam, erro < 1.2e-9).
+inline double normalQuantile(const double p) {
+    static constexpr double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                   1.383577518672690e+02,  -3.066479806614716e+01, 2.506628277459239e+00};
+    static constexpr double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                   6.680131188771972e+01,  -1.328068155288572e+01};
+    static constexpr double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                   -2.549732539343734e+00, 4.374664141464968e+00,  2.938163982698783e+00};
+    static constexpr double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                   3.754408661907416e+00};
+    constexpr double low = 0.02425;
+    if (p < low) {
+        const double q = std::sqrt(-2.0 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - low) return -normalQuantile(1.0 - p);
+    const double q = p - 0.5, r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+// Quantil da qui-quadrado (Wilson-Hilferty).
+inline double chiSquareQuantile(const double p, const double dof) {
+    const double z = normalQuantile(p), h = 2.0 / (9.0 * dof);
+    const double v = 1.0 - h + z * std::sqrt(h);
+    return dof * v * v * v;
+}
+
+// Quantil da t de Student (expansao de Cornish-Fisher, boa a partir de ~3 graus).
+inline double studentQuantile(const double p, const double dof) {
+    const double z = normalQuantile(p), z2 = z * z;
+    return z + z * (z2 + 1.0) / (4.0 * dof) + z * ((5.0 * z2 + 16.0) * z2 + 3.0) / (96.0 * dof * dof) +
+           z * (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) / (384.0 * dof * dof * dof);
+}
+
+// Postos 1..k dentro de um bloco, com media nos empates.
+inline std::vector<double> blockRanks(const std::vector<double> &costs) {
+    const size_t k = costs.size();
+    std::vector<size_t> idx(k);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::sort(idx.begin(), idx.end(), [&](const size_t a, const size_t b) { return costs[a] < costs[b]; });
+    std::vector<double> ranks(k);
+    for (size_t i = 0; i < k;) {
+        size_t j = i;
+        while (j + 1 < k && costs[idx[j + 1]] == costs[idx[i]]) ++j;
+        for (size_t t = i; t <= j; ++t) ranks[idx[t]] = (static_cast<double>(i + j) / 2.0) + 1.0;
+        i = j + 1;
+    }
+    return ranks;
+}
+
+// costs[i][j]: custo da configuracao viva j na instancia i. Devolve quem
+// sobrevive ao teste de Friedman e as comparacoes com o melhor posto.
+inline std::vector<bool> friedmanSurvivors(const std::vector<std::vector<double>> &costs, const double alpha) {
+    const size_t m = costs.size(), k = costs.front().size();
+    std::vector<bool> alive(k, true);
+    if (k < 2 || m < 2) return alive;
+    std::vector<double> rankSum(k, 0.0);
+    double sumSquares = 0.0;
+    for (const auto &row : costs) {
+        const std::vector<double> r = blockRanks(row);
+        for (size_t j = 0; j < k; ++j) {
+            rankSum[j] += r[j];
+            sumSquares += r[j] * r[j];
+        }
+    }
+    const double md = static_cast<double>(m), kd = static_cast<double>(k);
+    const double tieTerm = sumSquares - md * kd * (kd + 1.0) * (kd + 1.0) / 4.0;
+    if (tieTerm <= 0.0) return alive; // todos empatados em todos os blocos
+    double spread = 0.0;
+    for (const double r : rankSum) spread += (r - md * (kd + 1.0) / 2.0) * (r - md * (kd + 1.0) / 2.0);
+    const double statistic = (kd - 1.0) * spread / tieTerm;
+    if (statistic <= chiSquareQuantile(1.0 - alpha, kd - 1.0)) return alive;
+
+    // pos-teste: diferenca de soma de postos contra a melhor configuracao
+    const size_t best = static_cast<size_t>(std::min_element(rankSum.begin(), rankSum.end()) - rankSum.begin());
+    const double dof = (md - 1.0) * (kd - 1.0);
+    const double scale =
+        std::sqrt(2.0 * md * tieTerm * std::max(0.0, 1.0 - statistic / (md * (kd - 1.0))) / dof);
+    const double critical = studentQuantile(1.0 - alpha / 2.0, dof) * scale;
+    for (size_t j = 0; j < k; ++j) alive[j] = j == best || rankSum[j] - rankSum[best] <= critical;
+    return alive;
+}
+
+// Amostragem do espaco de parametros; a configuracao 0 de cada corrida e a
+// padrao (defaultAnnealingParams/defaultGAParams), para servir de referencia.
+inline double logUniform(RNG &rng, const double lo, const double hi) {
+    return std::exp(std::log(lo) + rng.rand01() * (std::log(hi) - std::log(lo)));
+}
+
+inline AnnealingParams sampleAnnealingParams(RNG &rng, const size_t n) {
+    AnnealingParams p;
+    p.initialTemp = logUniform(rng, 1.0, 1e4);
+    p.finalTemp = 1e-3;
+    p.alpha = 1.0 / (logUniform(rng, 0.02, 5.0) * static_cast<double>(n));
+    p.neighborsPerTemp = static_cast<unsigned int>(logUniform(rng, 5.0, 200.0));
+    p.stallLimit = static_cast<unsigned int>(logUniform(rng, 200.0, 20000.0));
+    p.candidateMoveRate = rng.rand01();
+    p.actualTemp = p.initialTemp;
+    return p;
+}
+
+inline GAParams sampleGAParams(RNG &rng) {
+    GAParams p;
+    p.populationSize = static_cast<size_t>(logUniform(rng, 50.0, 2000.0));
+    p.elitism = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(p.populationSize) * logUniform(rng, 0.005, 0.1)));
+    p.tournamentK = rng.randint(2, 10);
+    p.mutationRate = logUniform(rng, 0.01, 0.3);
+    p.stallLimit = static_cast<size_t>(logUniform(rng, 50.0, 2000.0));
+    p.numMutations = rng.randint(1, 3);
+    return p;
+}
+
+struct RaceParams {
+    size_t firstTest = 5; // instancias antes do primeiro teste
+    double alpha = 0.05;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+struct RaceResult {
+    size_t winner = 0;
+    std::vector<size_t> survivors;
+    size_t instancesUsed = 0;
+    // custo de cada configuracao em cada instancia (NaN depois de eliminada)
+    std::vector<std::vector<double>> costs;
+};
+
+// Corre numConfigs configuracoes sobre numInstances instancias.
+// evaluate(config, instance) devolve o custo de uma execucao; as
+// configuracoes vivas de cada instancia rodam em paralelo.
+inline RaceResult race(const size_t numConfigs, const size_t numInstances, const RaceParams &params,
+                       const std::function<double(size_t config, size_t instance)> &evaluate) {
+    RaceResult result;
+    result.survivors.resize(numConfigs);
+    std::iota(result.survivors.begin(), result.survivors.end(), 0);
+    for (size_t instance = 0; instance < numInstances && result.survivors.size() > 1; ++instance) {
+        std::vector<double> row(numConfigs, std::numeric_limits<double>::quiet_NaN());
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t t = next++; t < result.survivors.size(); t = next++)
+                row[result.survivors[t]] = evaluate(result.survivors[t], instance);
+        };
+        std::vector<std::thread> pool;
+        for (size_t w = 1; w < std::min(params.threads, result.survivors.size()); ++w) pool.emplace_back(worker);
+        worker();
+        for (auto &t : pool) t.join();
+        result.costs.push_back(row);
+        result.instancesUsed = instance + 1;
+
+        if (result.instancesUsed < params.firstTest) continue;
+        std::vector<std::vector<double>> alive;
+        for (const auto &r : result.costs) {
+            std::vector<double> a;
+            for (const size_t c : result.survivors) a.push_back(r[c]);
+            alive.push_back(std::move(a));
+        }
+        const std::vector<bool> keep = friedmanSurvivors(alive, params.alpha);
+        std::vector<size_t> survivors;
+        for (size_t j = 0; j < keep.size(); ++j)
+            if (keep[j]) survivors.push_back(result.survivors[j]);
+        result.survivors = std::move(survivors);
+    }
+
+    // vencedor: melhor soma de postos entre as sobreviventes
+    std::vector<double> rankSum(result.survivors.size(), 0.0);
+    for (const auto &r : result.costs) {
+        std::vector<double> a;
+        for (const size_t c : result.survivors) a.push_back(r[c]);
+        const std::vector<double> ranks = blockRanks(a);
+        for (size_t j = 0; j < ranks.size(); ++j) rankSum[j] += ranks[j];
+    }
+    result.winner = result.survivors[std::min_element(rankSum.begin(), rankSum.end()) - rankSum.begin()];
+    return result;
+}
+
+#endif //SALEMAN_TUNING_H
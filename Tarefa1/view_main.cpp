@@ -0,0 +1,229 @@
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <raylib.h>
+#include <string>
+#include <vector>
+
+#include "lod.h"
+#include "shared_view.h"
+#include "view_ui.h"
+
+#define ATTACH_RETRY_MS 500 // intervalo entre tentativas de conexao ao solver
+
+
+// Visualizador em processo separado: le o estado publicado por
+// "saleman --publish" na memoria compartilhada. Conecta quando o solver
+// aparece, mantem o ultimo estado na tela se ele terminar e pode ser fechado
+// e reaberto sem afetar a execucao.
+class LiveView
+{
+private:
+    std::string name;
+    int screenWidth, screenHeight;
+    int mapX = 50;
+
+    std::unique_ptr<SharedViewReader> reader;
+    std::chrono::steady_clock::time_point nextAttach{};
+    std::string status = "waiting for solver";
+
+    std::vector<City> cities;
+    double lowerBound = 0.0;
+    SharedSolverStats saStats, gaStats;
+    std::vector<CityId> saBest, saCurrent, gaBest, gaCurrent;
+    uint64_t instanceSeq = 0, saSeq = 0, gaSeq = 0;
+    bool dirty = true;
+    std::string isa = "-";
+
+    Camera2D camera{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 1.0f };
+    std::vector<Vector2> saBestPoints, saCurrentPoints, gaBestPoints, gaCurrentPoints;
+    std::vector<uint8_t> occupied;
+    std::vector<Vector2> pixels;
+    bool cityDetail = true;
+    UiLayout ui;
+
+    int MapBottom() const { return screenHeight - 250; }
+
+    ViewTransform PanelView(const int offsetX) const
+    {
+        return panelView(camera, offsetX, screenWidth / 2, MapBottom());
+    }
+
+    void Attach()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (reader || now < nextAttach) return;
+        nextAttach = now + std::chrono::milliseconds(ATTACH_RETRY_MS);
+        try
+        {
+            reader = std::make_unique<SharedViewReader>(name);
+            instanceSeq = saSeq = gaSeq = 0;
+            isa = reader->isa();
+            status = "attached to " + name;
+        }
+        catch (const std::exception& e)
+        {
+            status = e.what();
+        }
+    }
+
+    void Poll()
+    {
+        if (!reader) return;
+        if (!reader->alive())
+        {
+            reader.reset();
+            status = "solver stopped; showing its last state";
+            return;
+        }
+        dirty |= reader->readInstance(cities, lowerBound, instanceSeq);
+        dirty |= reader->readSolver(SharedChannel::Annealing, saStats, saBest, saCurrent, saSeq);
+        dirty |= reader->readSolver(SharedChannel::Genetic, gaStats, gaBest, gaCurrent, gaSeq);
+    }
+
+    // Tours de uma instancia antiga podem chegar antes das novas cidades.
+    void Decimate(const std::vector<CityId>& order, const int offsetX, std::vector<Vector2>& out) const
+    {
+        for (const CityId c : order)
+        {
+            if (c >= cities.size())
+            {
+                out.clear();
+                return;
+            }
+        }
+        decimateTour(order, cities, PanelView(offsetX), out);
+    }
+
+    void Rebuild()
+    {
+        if (!dirty) return;
+        const size_t visible = cityPoints(cities, PanelView(0), occupied, pixels);
+        cityDetail = showCityDetail(camera.zoom, visible);
+        Decimate(saCurrent, 0, saCurrentPoints);
+        Decimate(saBest, 0, saBestPoints);
+        Decimate(gaCurrent, screenWidth / 2, gaCurrentPoints);
+        Decimate(gaBest, screenWidth / 2, gaBestPoints);
+
+        ViewStats stats;
+        stats.saTemperature = saStats.temperature;
+        stats.saBest = saStats.best;
+        stats.saCurrent = saStats.current;
+        stats.saIterations = saStats.step;
+        stats.saFinished = saStats.finished != 0;
+        stats.gaGeneration = gaStats.step;
+        stats.gaBest = gaStats.best;
+        stats.gaCurrent = gaStats.current;
+        stats.hasGaCurrent = !gaCurrent.empty();
+        stats.gaStall = gaStats.stall;
+        stats.gaFinished = gaStats.finished != 0;
+        stats.lowerBound = lowerBound;
+        stats.isa = isa;
+        stats.help = "Live view (" + status + "). Wheel/drag to zoom/pan, 0 to reset view";
+        buildUi(stats, screenWidth, screenHeight, mapX, ui);
+        dirty = false;
+    }
+
+    void DrawCities(const int offsetX) const
+    {
+        if (!cityDetail)
+        {
+            for (const Vector2& p : pixels) DrawPixelV({ p.x + static_cast<float>(offsetX), p.y }, SKYBLUE);
+            return;
+        }
+        const ViewTransform view = PanelView(offsetX);
+        for (const City& c : cities)
+        {
+            const float sx = view.screenX(static_cast<float>(c.x));
+            const float sy = view.screenY(static_cast<float>(c.y));
+            if (!view.contains(sx, sy)) continue;
+            DrawCircleV({ sx, sy }, 8.0f * view.zoom, DARKBLUE);
+            DrawCircleV({ sx, sy }, 6.0f * view.zoom, SKYBLUE);
+            const std::string s = std::to_string(c.tag);
+            const int size = static_cast<int>(10.0f * view.zoom);
+            DrawText(s.c_str(), static_cast<int>(sx) - MeasureText(s.c_str(), size) / 2, static_cast<int>(sy) - size / 2, size, WHITE);
+        }
+    }
+
+public:
+    LiveView(std::string segment, const int width, const int height)
+        : name(std::move(segment)), screenWidth(width), screenHeight(height) {}
+
+    void Update()
+    {
+        const std::string before = status;
+        Attach();
+        Poll();
+        dirty |= status != before;
+
+        if (IsKeyPressed(KEY_ZERO))
+        {
+            camera = Camera2D{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, 0.0f, 1.0f };
+            dirty = true;
+        }
+        Vector2 mouse = GetMousePosition();
+        if (mouse.y < static_cast<float>(MapBottom()))
+        {
+            const float panelW = static_cast<float>(screenWidth / 2);
+            if (mouse.x >= panelW) mouse.x -= panelW;
+            dirty |= panZoomCamera(camera, mouse);
+        }
+    }
+
+    void Draw()
+    {
+        Rebuild();
+
+        BeginDrawing();
+        ClearBackground(Color{ 15, 20, 35, 255 });
+
+        const int centerX = screenWidth / 2;
+        DrawLine(centerX, 0, centerX, MapBottom(), GRAY);
+        const float thin = cityDetail ? 2.0f : 1.0f;
+        const float thick = cityDetail ? 3.0f : 2.0f;
+
+        BeginScissorMode(0, 0, centerX, MapBottom());
+        drawPath(saCurrentPoints, ORANGE, thin);
+        drawPath(saBestPoints, RED, thick);
+        DrawCities(0);
+        EndScissorMode();
+
+        BeginScissorMode(centerX, 0, centerX, MapBottom());
+        drawPath(gaCurrentPoints, LIGHTGRAY, thin);
+        drawPath(gaBestPoints, GREEN, thick);
+        DrawCities(centerX);
+        EndScissorMode();
+
+        drawUi(ui);
+
+        EndDrawing();
+    }
+
+    void Run()
+    {
+        while (!WindowShouldClose())
+        {
+            Update();
+            Draw();
+        }
+    }
+};
+
+// saleman_view [nome]   acompanha um "saleman --publish [nome]" em andamento
+int main(int argc, char** argv)
+{
+    constexpr int screenWidth = 1680;
+    constexpr int screenHeight = 720;
+
+    InitWindow(screenWidth, screenHeight, "TSP: live view");
+    SetTargetFPS(60);
+
+    {
+        LiveView app(argc >= 2 ? argv[1] : sharedViewName, screenWidth, screenHeight);
+        app.Run();
+    }
+
+    CloseWindow();
+    return 0;
+}
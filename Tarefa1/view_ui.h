@@ -0,0 +1,167 @@
+#ifndef SALEMAN_VIEW_UI_H
+#define SALEMAN_VIEW_UI_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <raylib.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lod.h"
+
+// Partes do visualizador compartilhadas entre o saleman e o saleman_view:
+// o layout do painel de estatisticas como dados (desenhado pela raylib ou
+// pelo rasterizador de raster.h), a vista de cada painel do mapa e o
+// controle de pan/zoom da camera.
+
+// Segmento de memoria compartilhada que o "saleman --publish" escreve e o
+// saleman_view le, quando nenhum nome e passado.
+inline constexpr char sharedViewName[] = "/saleman";
+
+struct UiBox {
+    int x, y, w, h;
+    Color fill, border;
+};
+
+struct UiText {
+    std::string text;
+    int x, y, size;
+    Color color;
+};
+
+struct UiLayout {
+    std::vector<UiBox> boxes;
+    std::vector<UiText> texts;
+};
+
+// O que o painel mostra, venha dos estados dos solvers ou da memoria compartilhada.
+struct ViewStats {
+    bool showSA = true, showGA = true;
+    double saTemperature = 0.0;
+    double saBest = std::numeric_limits<double>::infinity();
+    double saCurrent = std::numeric_limits<double>::infinity();
+    uint64_t saIterations = 0;
+    bool saFinished = false;
+    uint64_t gaGeneration = 0;
+    double gaBest = std::numeric_limits<double>::infinity();
+    double gaCurrent = std::numeric_limits<double>::infinity();
+    bool hasGaCurrent = false;
+    uint64_t gaStall = 0;
+    bool gaFinished = false;
+    double lowerBound = 0.0;
+    std::string isa;
+    std::string help;
+};
+
+inline void buildUi(const ViewStats &stats, const int screenWidth, const int screenHeight, const int mapX,
+                    UiLayout &ui) {
+    ui.boxes.clear();
+    ui.texts.clear();
+    auto text = [&ui](std::string s, const int x, const int y, const int size, const Color c) {
+        ui.texts.push_back({std::move(s), x, y, size, c});
+    };
+    auto fmt = [](const char *label, const double value) {
+        std::ostringstream ss;
+        ss << label << std::fixed << std::setprecision(1) << value;
+        return ss.str();
+    };
+
+    const int uiY = screenHeight - 240;
+    const int uiHeight = 220;
+    const int leftX = 20;
+    const int rightX = screenWidth / 2 + 20;
+    const int uiWidth = screenWidth / 2 - 40;
+
+    if (stats.showSA) text("Simulated Annealing", mapX, 20, 20, YELLOW);
+    if (stats.showGA) text("Genetic Algorithm", mapX + screenWidth / 2, 20, 20, LIME);
+
+    ui.boxes.push_back({leftX, uiY, uiWidth, uiHeight, Fade(BLACK, 0.85f), RAYWHITE});
+    text("Simulated Annealing", leftX + 12, uiY + 8, 20, YELLOW);
+    std::ostringstream tss;
+    tss << "Temperature: " << std::scientific << std::setprecision(2) << stats.saTemperature;
+    text(tss.str(), leftX + 12, uiY + 35, 12, YELLOW);
+    text(fmt("Best Distance: ", stats.saBest), leftX + 12, uiY + 55, 12, GREEN);
+    text(fmt("Current Distance: ", stats.saCurrent), leftX + 12, uiY + 75, 12, ORANGE);
+    text("Iterations: " + std::to_string(stats.saIterations), leftX + 12, uiY + 95, 12, LIGHTGRAY);
+    if (stats.saFinished) text("FINISHED", leftX + 12, uiY + 115, 14, GREEN);
+
+    ui.boxes.push_back({rightX, uiY, uiWidth, uiHeight, Fade(BLACK, 0.85f), RAYWHITE});
+    text("Genetic Algorithm", rightX + 12, uiY + 8, 20, LIME);
+    text("Generation: " + std::to_string(stats.gaGeneration), rightX + 12, uiY + 35, 12, LIME);
+    text(fmt("Best Distance: ", stats.gaBest), rightX + 12, uiY + 55, 12, GREEN);
+    if (stats.hasGaCurrent) text(fmt("Current Distance: ", stats.gaCurrent), rightX + 12, uiY + 75, 12, ORANGE);
+    text("Stall Counter: " + std::to_string(stats.gaStall), rightX + 12, uiY + 95, 12, LIGHTGRAY);
+    if (stats.gaFinished) text("FINISHED", rightX + 12, uiY + 115, 14, GREEN);
+
+    const int compY = uiY + 140;
+    text("Comparison:", leftX, compY, 16, WHITE);
+    if (stats.saBest < stats.gaBest)
+        text("SA is winning!", leftX, compY + 25, 14, YELLOW);
+    else if (stats.gaBest < stats.saBest)
+        text("GA is winning!", leftX, compY + 25, 14, LIME);
+    else
+        text("Tie!", leftX, compY + 25, 14, WHITE);
+    text(fmt("Difference: ", std::abs(stats.saBest - stats.gaBest)), leftX, compY + 45, 12, GRAY);
+    text(fmt("Lower Bound (MST): ", stats.lowerBound), leftX, compY + 60, 12, GRAY);
+    text("Kernels: " + stats.isa, leftX + 200, compY + 60, 12, GRAY);
+
+    text(stats.help, 20, screenHeight - 20, 12, WHITE);
+}
+
+inline void drawUi(const UiLayout &ui) {
+    for (const UiBox &b : ui.boxes) {
+        DrawRectangle(b.x, b.y, b.w, b.h, b.fill);
+        DrawRectangleLines(b.x, b.y, b.w, b.h, b.border);
+    }
+    for (const UiText &t : ui.texts) DrawText(t.text.c_str(), t.x, t.y, t.size, t.color);
+}
+
+// Vista de um painel do mapa (metade da tela, a partir de offsetX) com a
+// camera compartilhada pelos dois paineis.
+inline ViewTransform panelView(const Camera2D &camera, const int offsetX, const int panelWidth,
+                               const int bottom) {
+    ViewTransform view;
+    view.targetX = camera.target.x;
+    view.targetY = camera.target.y;
+    view.offsetX = camera.offset.x + static_cast<float>(offsetX);
+    view.offsetY = camera.offset.y;
+    view.zoom = camera.zoom;
+    view.left = static_cast<float>(offsetX);
+    view.right = static_cast<float>(offsetX + panelWidth);
+    view.bottom = static_cast<float>(bottom);
+    return view;
+}
+
+// Um unico strip por tour em vez de uma chamada DrawLineEx por aresta.
+inline void drawPath(const std::vector<Vector2> &points, const Color c, const float thick) {
+    if (points.size() < 2) return;
+    DrawSplineLinear(points.data(), static_cast<int>(points.size()), thick, c);
+}
+
+// Roda do mouse aproxima em torno do cursor e arrastar com o botao esquerdo
+// move a vista. mouse ja em coordenadas do painel; devolve se a camera mudou.
+inline bool panZoomCamera(Camera2D &camera, const Vector2 mouse) {
+    bool changed = false;
+    const float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f) {
+        const Vector2 world = GetScreenToWorld2D(mouse, camera);
+        camera.offset = mouse;
+        camera.target = world;
+        camera.zoom = std::clamp(camera.zoom * (wheel > 0.0f ? 1.25f : 0.8f), 0.05f, 256.0f);
+        changed = true;
+    }
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+        const Vector2 delta = GetMouseDelta();
+        if (delta.x != 0.0f || delta.y != 0.0f) {
+            camera.target.x -= delta.x / camera.zoom;
+            camera.target.y -= delta.y / camera.zoom;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+#endif //SALEMAN_VIEW_UI_H